@@ -0,0 +1,314 @@
+/*
+ * Allocator Benchmark Suite (Google Benchmark)
+ *
+ * Covers std::allocator, PoolAllocator, ThreadSafePoolAllocator, ArenaAllocator and
+ * TrackingAllocator on list / map / vector / unordered_map workloads with 16, 64 and
+ * 256-byte objects. Unlike run_benchmarks() in allocators_practice.cpp every case is
+ * warmed up, repeated and reported as mean/median/stddev/cv.
+ *
+ * Usage:
+ *   ./allocator_bench                                   # 5 repetitions, aggregates only
+ *   ./allocator_bench --benchmark_filter='list/.*'      # one workload
+ *   cmake --build . --target allocator_bench_json       # writes allocator_bench.json
+ *
+ * Counters:
+ *   time_per_op     wall time per container operation (seconds; console shows n = ns)
+ *   allocs_per_sec  calls into the allocator per second
+ *   allocs_per_iter calls into the allocator per iteration (same for every allocator)
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "allocators.hpp"
+
+namespace {
+
+constexpr size_t pool_bytes = 64 * 1024;
+
+template <size_t Size>
+struct Object {
+    uint64_t key = 0;
+    std::array<char, Size - sizeof(uint64_t)> payload{};
+
+    Object() = default;
+    explicit Object(uint64_t k) : key(k) {}
+};
+
+// =============================================================================
+// Allocator kinds: each owns what its allocator needs and lives for the whole run,
+// so pools stay warm between iterations and their destruction output comes at exit
+// =============================================================================
+
+struct StdKind {
+    static constexpr const char* name = "std";
+
+    template <typename T>
+    using Allocator = std::allocator<T>;
+
+    template <typename T>
+    Allocator<T> get() {
+        return {};
+    }
+
+    void end_iteration() {}
+};
+
+struct PoolKind {
+    static constexpr const char* name = "pool";
+
+    template <typename T>
+    using Allocator = PoolAllocator<T, pool_bytes>;
+
+    std::shared_ptr<PoolResource> resource = std::make_shared<PoolResource>(pool_bytes);
+
+    template <typename T>
+    Allocator<T> get() {
+        return Allocator<T>(resource);
+    }
+
+    void end_iteration() {}
+};
+
+struct ThreadSafePoolKind {
+    static constexpr const char* name = "thread_safe_pool";
+
+    template <typename T>
+    using Allocator = ThreadSafePoolAllocator<T, pool_bytes>;
+
+    Allocator<char> root;
+
+    template <typename T>
+    Allocator<T> get() {
+        return Allocator<T>(root);
+    }
+
+    void end_iteration() {}
+};
+
+struct ArenaKind {
+    static constexpr const char* name = "arena";
+
+    template <typename T>
+    using Allocator = ArenaAllocator<T>;
+
+    Arena arena{1 << 20, ArenaGrowthPolicy{}};
+
+    template <typename T>
+    Allocator<T> get() {
+        return Allocator<T>(&arena);
+    }
+
+    // Every container of the iteration is gone, so the whole arena can go at once
+    void end_iteration() {
+        arena.reset();
+    }
+};
+
+struct TrackingKind {
+    static constexpr const char* name = "tracking";
+
+    template <typename T>
+    using Allocator = TrackingAllocator<T>;
+
+    std::shared_ptr<TrackingDomain> domain = TrackingDomain::create("allocator_bench");
+
+    template <typename T>
+    Allocator<T> get() {
+        return Allocator<T>(domain);
+    }
+
+    void end_iteration() {}
+};
+
+template <typename Kind>
+Kind& context() {
+    static Kind kind;
+    return kind;
+}
+
+// =============================================================================
+// Workloads: run() returns the number of container operations it performed
+// =============================================================================
+
+struct ListWorkload {
+    static constexpr const char* name = "list";
+
+    template <typename Obj, typename Alloc>
+    static size_t run(const Alloc& alloc, const std::vector<uint64_t>& keys) {
+        std::list<Obj, Alloc> list(alloc);
+        for (uint64_t key : keys) {
+            list.emplace_back(key);
+        }
+        for (size_t i = 0; i < keys.size() / 2; ++i) {
+            list.pop_front();
+        }
+        for (size_t i = 0; i < keys.size() / 2; ++i) {
+            list.emplace_back(keys[i]);
+        }
+        benchmark::DoNotOptimize(list.back().key);
+        return 2 * keys.size();
+    }
+};
+
+struct MapWorkload {
+    static constexpr const char* name = "map";
+
+    template <typename Obj, typename Alloc>
+    static size_t run(const Alloc& alloc, const std::vector<uint64_t>& keys) {
+        using Value = std::pair<const uint64_t, Obj>;
+        using Rebound = typename std::allocator_traits<Alloc>::template rebind_alloc<Value>;
+
+        std::map<uint64_t, Obj, std::less<uint64_t>, Rebound> map{Rebound(alloc)};
+        for (uint64_t key : keys) {
+            map.emplace(key, Obj(key));
+        }
+        benchmark::DoNotOptimize(map.begin()->second.key);
+        for (size_t i = 0; i < keys.size(); i += 2) {
+            map.erase(keys[i]);
+        }
+        return keys.size() + (keys.size() + 1) / 2;
+    }
+};
+
+struct UnorderedMapWorkload {
+    static constexpr const char* name = "unordered_map";
+
+    template <typename Obj, typename Alloc>
+    static size_t run(const Alloc& alloc, const std::vector<uint64_t>& keys) {
+        using Value = std::pair<const uint64_t, Obj>;
+        using Rebound = typename std::allocator_traits<Alloc>::template rebind_alloc<Value>;
+        using Map = std::unordered_map<uint64_t, Obj, std::hash<uint64_t>,
+                                       std::equal_to<uint64_t>, Rebound>;
+
+        Map map{0, std::hash<uint64_t>(), std::equal_to<uint64_t>(), Rebound(alloc)};
+        for (uint64_t key : keys) {
+            map.emplace(key, Obj(key));
+        }
+        benchmark::DoNotOptimize(map.find(keys.front())->second.key);
+        for (size_t i = 0; i < keys.size(); i += 2) {
+            map.erase(keys[i]);
+        }
+        return keys.size() + (keys.size() + 1) / 2;
+    }
+};
+
+// No reserve(), so the growth reallocations are part of the measurement
+struct VectorWorkload {
+    static constexpr const char* name = "vector";
+
+    template <typename Obj, typename Alloc>
+    static size_t run(const Alloc& alloc, const std::vector<uint64_t>& keys) {
+        std::vector<Obj, Alloc> vec(alloc);
+        for (uint64_t key : keys) {
+            vec.emplace_back(key);
+        }
+        benchmark::DoNotOptimize(vec.data());
+        benchmark::ClobberMemory();
+        return keys.size();
+    }
+};
+
+std::vector<uint64_t> shuffled_keys(size_t n) {
+    std::vector<uint64_t> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = i;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+    return keys;
+}
+
+// Container behaviour doesn't depend on the allocator, so one tracked run gives the
+// allocation count of every kind
+template <typename Workload, typename Obj>
+size_t allocations_per_run(const std::vector<uint64_t>& keys) {
+    TrackingAllocator<Obj> probe(TrackingDomain::create("probe"));
+    Workload::template run<Obj>(probe, keys);
+    return probe.get_allocation_count();
+}
+
+template <typename Kind, typename Workload, typename Obj>
+void BM_Workload(benchmark::State& state) {
+    const std::vector<uint64_t> keys = shuffled_keys(static_cast<size_t>(state.range(0)));
+    const size_t allocs = allocations_per_run<Workload, Obj>(keys);
+
+    Kind& kind = context<Kind>();
+    size_t ops = 0;
+    for (auto _ : state) {
+        ops = Workload::template run<Obj>(kind.template get<Obj>(), keys);
+        kind.end_iteration();
+    }
+
+    const double iterations = static_cast<double>(state.iterations());
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ops));
+    state.counters["time_per_op"] = benchmark::Counter(
+        iterations * ops, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["allocs_per_sec"] =
+        benchmark::Counter(iterations * allocs, benchmark::Counter::kIsRate);
+    state.counters["allocs_per_iter"] = static_cast<double>(allocs);
+}
+
+// =============================================================================
+// Registration: <workload>/<allocator>/<object size>/<element count>
+// =============================================================================
+
+constexpr int64_t element_count = 4096;
+
+template <typename Kind, typename Obj, typename Workload>
+void register_workload() {
+    const std::string name = std::string(Workload::name) + "/" + Kind::name + "/" +
+                             std::to_string(sizeof(Obj)) + "B";
+    benchmark::RegisterBenchmark(name.c_str(), BM_Workload<Kind, Workload, Obj>)
+        ->Arg(element_count);
+}
+
+template <typename Kind, typename Obj>
+void register_size() {
+    register_workload<Kind, Obj, ListWorkload>();
+    register_workload<Kind, Obj, MapWorkload>();
+    register_workload<Kind, Obj, UnorderedMapWorkload>();
+    register_workload<Kind, Obj, VectorWorkload>();
+}
+
+template <typename Kind>
+void register_kind() {
+    register_size<Kind, Object<16>>();
+    register_size<Kind, Object<64>>();
+    register_size<Kind, Object<256>>();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    register_kind<StdKind>();
+    register_kind<PoolKind>();
+    register_kind<ThreadSafePoolKind>();
+    register_kind<ArenaKind>();
+    register_kind<TrackingKind>();
+
+    // Defaults first so anything passed on the command line overrides them
+    std::vector<char*> args{argv[0]};
+    char repetitions[] = "--benchmark_repetitions=5";
+    char aggregates[] = "--benchmark_report_aggregates_only=true";
+    args.push_back(repetitions);
+    args.push_back(aggregates);
+    args.insert(args.end(), argv + 1, argv + argc);
+    int args_count = static_cast<int>(args.size());
+
+    benchmark::Initialize(&args_count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(args_count, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
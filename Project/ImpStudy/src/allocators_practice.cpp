@@ -10,7 +10,9 @@
  * 5. Test with provided test cases
  *
  * Compile with:
- * clang++ -std=c++20 -Wall -Wextra -O2 custom_allocators_exercise.cpp -o allocators
+ * clang++ -std=c++20 -Wall -Wextra -O2 -Iinclude allocators_practice.cpp particle_kernels.cpp \
+ *     -o allocators
+ * (scalar particle kernel only; CMake also builds the SSE2/AVX2/AVX-512 ones)
  *
  * DIFFICULTY LEVELS:
  * ⭐ Basic - Simple pool allocator
@@ -19,831 +21,981 @@
  * 🌟 Expert - Polymorphic allocator wrapper
  */
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <list>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <new>
+#include <random>
+#include <span>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include "allocators.hpp"
+#include "particle_system.hpp"
+#include "perf_counters.hpp"
+#include "task_scheduler.hpp"
+
 // =============================================================================
-// Exercise 1: ⭐ Basic Pool Allocator
+// Test Data Structures
 // =============================================================================
 
-/*
- * GOAL: Implement a pool allocator for fixed-size allocations
- *
- * Pool allocators are ideal for:
- * - Frequent allocations/deallocations of same-sized objects
- * - Game entities, particles, audio samples
- * - Linked lists, trees, graphs
- *
- * Performance target: 5-10x faster than default allocator
- */
-
-template <typename T, size_t PoolSize = 1024>
-class PoolAllocator {
-private:
-    // TODO: Define your data structures
-    // Hints:
-    // - Use a union for free list (stores either T or next pointer)
-    // - Keep track of free blocks
-    // - May need multiple pools if one fills up
-
-    union Block {
-        // TODO: Implement Block structure
-        // When free: stores pointer to next free block
-        // When allocated: stores actual T object
-        T element;
-        Block* next;
-    };
-
-    struct Pool {
-        // TODO: Implement Pool structure
-        // Should contain:
-        // - Array of blocks
-        // - Pointer to next vector<Block> blocks;
-        static constexpr size_t blocks_per_pool = PoolSize / sizeof(Block);
-        alignas(Block) char blocks[PoolSize];
-        Pool* next;
-    };
+// Simple game entity for testing
+struct Entity {
+    int id;
+    float x, y, z;
+    float velocity_x, velocity_y;
+    int health;
 
-    struct PoolState {
-        Block* free_list_ = nullptr;
-        Pool* current_pool_ = nullptr;
-        size_t total_allocated_ = 0;
-        size_t total_deallocated_ = 0;
-
-        ~PoolState() {
-            while (current_pool_) {
-                Pool* next = current_pool_->next;
-                ::operator delete(current_pool_);
-                current_pool_ = next;
-            }
+    Entity(int i = 0) : id(i), x(0), y(0), z(0), velocity_x(0), velocity_y(0), health(100) {}
+};
 
-            // Print statistics
-            std::cout << "🏊 PoolAllocator destroyed\n";
-            std::cout << "   Allocated: " << total_allocated_ << "\n";
-            std::cout << "   Deallocated: " << total_deallocated_ << "\n";
+// Particle for performance testing
+struct Particle {
+    float x, y, z;
+    float vx, vy, vz;
+    float life;
+    int color;
+};
 
-            // Check for leaks
-            if (total_allocated_ != total_deallocated_) {
-                std::cout << "⚠️  Memory leak: " << (total_allocated_ - total_deallocated_)
-                          << " objects not freed!\n";
-            }
-        }
-    };
-    // TODO: Add member variables
-    std::shared_ptr<PoolState> state_;
+// =============================================================================
+// Benchmark Functions
+// =============================================================================
 
-public:
-    using value_type = T;
+template <typename Allocator>
+void benchmark_list_operations(const std::string& name, int iterations = 100000) {
+    using namespace std::chrono;
 
-    // TODO: Implement constructor
-    PoolAllocator() noexcept : state_(std::make_shared<PoolState>()) {
-        std::cout << "🏊 PoolAllocator created for type: " << typeid(T).name() << "\n";
-    }
+    PerfCounters perf;
+    perf.start();
+    auto start = high_resolution_clock::now();
 
-    // TODO: Implement destructor
-    ~PoolAllocator() = default;
+    {
+        std::list<int, Allocator> my_list;
 
-    // TODO: Implement copy constructor (for rebinding)
-    template <typename U>
-    PoolAllocator(const PoolAllocator<U, PoolSize>&) noexcept
-        : state_(std::make_shared<PoolState>()) {}
+        // Allocations
+        for (int i = 0; i < iterations; ++i) {
+            my_list.push_back(i);
+        }
 
-    // TODO: Implement allocate
-    T* allocate(size_t n) {
-        // Hints:
-        // 1. If n != 1, fall back to ::operator new (pools are for single objects)
-        // 2. If free_list_ is empty, create new pool (expand_pool())
-        // 3. Pop a block from free list
-        // 4. Update statistics
-        // 5. Return pointer to block (cast appropriately)
-        if (n != 1) {
-            return static_cast<T*>(::operator new(n * sizeof(T)));
+        // Mixed operations
+        for (int i = 0; i < iterations / 2; ++i) {
+            my_list.pop_front();
         }
 
-        if (!state_->free_list_) {
-            expand_pool();
+        for (int i = 0; i < iterations / 2; ++i) {
+            my_list.push_back(i);
         }
 
-        Block* new_block = state_->free_list_;
-        state_->free_list_ = state_->free_list_->next;
-        state_->total_allocated_++;
-        return reinterpret_cast<T*>(new_block);
+        // Deallocations happen here when list is destroyed
     }
 
-    // TODO: Implement deallocate
-    void deallocate(T* ptr, size_t n) {
-        // Hints:
-        // 1. If n != 1, use ::operator delete
-        // 2. Cast pointer to Block*
-        // 3. Push block back onto free list
-        // 4. Update statistics
-        // 5. Don't actually free memory (reuse it!)
+    auto end = high_resolution_clock::now();
+    PerfCounters::Reading counters = perf.stop();
+    auto duration = duration_cast<milliseconds>(end - start);
 
-        if (n != 1) {
-            ::operator delete(ptr);
-            return;
-        }
-        Block* rm_block = reinterpret_cast<Block*>(ptr);
-        state_->total_deallocated_++;
-        rm_block->next = state_->free_list_;
-        state_->free_list_ = rm_block;
-    }
+    // Ops: n push_back, n/2 pop_front, n/2 push_back, n frees when the list is destroyed
+    std::cout << name << ": " << duration.count() << " ms\n";
+    perf.print_per_op(counters, 3.0 * iterations);
+}
 
-    // TODO: Implement rebind for different types
-    template <typename U>
-    struct rebind {
-        using other = PoolAllocator<U, PoolSize>;
-    };
+template <typename Allocator>
+void benchmark_vector_of_entities(const std::string& name, int count = 10000) {
+    using namespace std::chrono;
 
-    // TODO: Implement statistics methods
-    size_t allocated_count() const {
-        return state_->total_allocated_;
-    }
+    auto start = high_resolution_clock::now();
 
-    size_t deallocated_count() const {
-        return state_->total_deallocated_;
-    }
+    {
+        std::vector<Entity, Allocator> entities;
+        entities.reserve(count);
+
+        for (int i = 0; i < count; ++i) {
+            entities.emplace_back(i);
+        }
 
-    size_t current_usage() const {
-        return state_->total_allocated_ - state_->total_deallocated_;
+        // Simulate updates
+        for (auto& e : entities) {
+            e.x += e.velocity_x;
+            e.y += e.velocity_y;
+        }
     }
 
-private:
-    // TODO: Implement expand_pool helper
-    void expand_pool() {
-        // Hints:
-        // 1. Allocate new Pool with ::operator new
-        // 2. Link all blocks in pool to free list
-        // 3. Link pool to existing pools (if tracking multiple)
+    auto end = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(end - start);
 
-        Pool* new_pool = static_cast<Pool*>(::operator new(sizeof(Pool)));
-        new_pool->next = state_->current_pool_;
-        state_->current_pool_ = new_pool;
+    std::cout << name << ": " << duration.count() << " μs\n";
+}
+
+// A particle emitter's frame: emit `particles`, update them, free them all. Compares one
+// allocate(1)/deallocate(1) per particle with a single allocate_n/deallocate_n per frame.
+template <typename Allocator>
+void benchmark_bulk_allocation(const std::string& name, int frames = 200,
+                               size_t particles = 10000) {
+    using namespace std::chrono;
+
+    Allocator alloc;
+    std::vector<Particle*> emitted(particles);
 
-        Block* blocks_ptr = reinterpret_cast<Block*>(state_->current_pool_->blocks);
-        for (size_t i = 0; i < Pool::blocks_per_pool - 1; i++) {
-            blocks_ptr[i].next = &blocks_ptr[i + 1];
+    auto frame = [&](auto&& emit, auto&& release) {
+        emit();
+        for (Particle* p : emitted) {
+            p->life = 1.0f;
+            p->x += p->vx;
         }
-        blocks_ptr[Pool::blocks_per_pool - 1].next = state_->free_list_;
-        state_->free_list_ = blocks_ptr;
-    }
-};
+        release();
+    };
 
-// TODO: Implement comparison operators (required for C++17+)
-template <typename T, typename U, size_t PoolSize>
-bool operator==(const PoolAllocator<T, PoolSize>&, const PoolAllocator<U, PoolSize>&) noexcept {
-    return true;
-}
+    auto start = high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        frame(
+            [&] {
+                for (auto& p : emitted) {
+                    p = alloc.allocate(1);
+                }
+            },
+            [&] {
+                for (Particle* p : emitted) {
+                    alloc.deallocate(p, 1);
+                }
+            });
+    }
+    auto middle = high_resolution_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        frame([&] { alloc.allocate_n(emitted); }, [&] { alloc.deallocate_n(emitted); });
+    }
+    auto end = high_resolution_clock::now();
 
-template <typename T, typename U, size_t PoolSize>
-bool operator!=(const PoolAllocator<T, PoolSize>&, const PoolAllocator<U, PoolSize>&) noexcept {
-    return false;
+    auto per_call = duration_cast<microseconds>(middle - start).count();
+    auto batched = duration_cast<microseconds>(end - middle).count();
+    std::cout << name << ": per call " << per_call << " μs, batched " << batched << " μs ("
+              << static_cast<double>(per_call) / std::max<long long>(batched, 1) << "x)\n";
 }
 
-// =============================================================================
-// Exercise 2: ⭐⭐ Arena (Stack) Allocator
-// =============================================================================
+// Every thread hammers the *same* allocator instance, so the shared PoolState is contended
+template <typename Allocator>
+void benchmark_thread_scaling(const std::string& name, int ops_per_thread = 200000) {
+    using namespace std::chrono;
 
-/*
- * GOAL: Implement an arena allocator for batch allocations
- *
- * Arena allocators are ideal for:
- * - Per-frame allocations in games
- * - Request-scoped allocations in servers
- * - Parsing/compilation temporary data
- *
- * Key feature: Deallocate everything at once (reset)
- */
+    const unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+    constexpr int burst = 32;
 
-class Arena {
-private:
-    // TODO: Add member variables
-    char* buffer_;       // Pointer to memory block
-    size_t size_;        // Total size
-    size_t offset_;      // Current allocation offset
-    size_t peak_usage_;  // Peak memory usage (statistics)
+    std::cout << name << ":\n";
+    for (unsigned num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        Allocator shared_alloc;
 
-public:
-    // TODO: Implement constructor
-    explicit Arena(size_t size) : size_(size), offset_(0), peak_usage_(0) {
-        // Hints:
-        // - Allocate buffer_ with new char[size]
-        // - Initialize offset_ to 0
-        // - Print creation message
-        buffer_ = new char[size];
-        std::cout << "🏟️ Arena created (" << size << " bytes)\n";
-    }
-
-    // TODO: Implement destructor
-    ~Arena() {
-        // Hints:
-        // - Delete buffer_
-        // - Print destruction message with statistics
-        if (buffer_) {
-            delete[] buffer_;
-        }
-
-        std::cout << "🏟️ Arena destroyed\n";
-        std::cout << "   Total size: " << size_ << " bytes\n";
-        std::cout << "   Peak usage: " << peak_usage_ << " bytes\n";
-        std::cout << "   Utilization: " << (100.0 * peak_usage_ / size_) << "%\n";
-    }
-
-    // Arena should not be copyable (it owns memory)
-    Arena(const Arena&) = delete;
-    Arena& operator=(const Arena&) = delete;
-
-    // TODO: Implement move constructor and assignment if desired
-    Arena(Arena&& other) noexcept
-        : buffer_(other.buffer_),
-          size_(other.size_),
-          offset_(other.offset_),
-          peak_usage_(other.peak_usage_) {
-        other.buffer_ = nullptr;
-    }
-
-    Arena& operator=(Arena&& other) noexcept {
-        if (this != &other) {
-            if (buffer_) {
-                delete[] buffer_;
+        auto start = high_resolution_clock::now();
+        {
+            std::vector<std::thread> threads;
+            for (unsigned t = 0; t < num_threads; ++t) {
+                threads.emplace_back([&shared_alloc, ops_per_thread]() {
+                    Allocator alloc = shared_alloc;
+                    typename Allocator::value_type* ptrs[burst];
+                    for (int i = 0; i < ops_per_thread; i += burst) {
+                        for (int j = 0; j < burst; ++j) {
+                            ptrs[j] = alloc.allocate(1);
+                        }
+                        for (int j = 0; j < burst; ++j) {
+                            alloc.deallocate(ptrs[j], 1);
+                        }
+                    }
+                });
             }
-            buffer_ = other.buffer_;
-            size_ = other.size_;
-            offset_ = other.offset_;
-            peak_usage_ = other.peak_usage_;
-
-            other.buffer_ = nullptr;
-        }
-        return *this;
-    }
-
-    // TODO: Implement allocate with alignment
-    void* allocate(size_t n, size_t alignment = alignof(std::max_align_t)) {
-        // Hints:
-        // 1. Calculate aligned offset using std::align
-        // 2. Check if enough space available
-        // 3. Update offset_
-        // 4. Update peak_usage_
-        // 5. Return pointer to allocated memory
-        // 6. Throw std::bad_alloc if not enough space
-        void* ptr = buffer_ + offset_;
-        size_t space = size_ - offset_;
-
-        if (std::align(alignment, n, ptr, space)) {
-            size_t aligned_offset = static_cast<char*>(ptr) - buffer_;
-            offset_ = aligned_offset + n;
-            if (offset_ > peak_usage_) {
-                peak_usage_ = offset_;
+            for (auto& t : threads) {
+                t.join();
             }
-            // Debug output
-            std::cout << "  📦 Arena allocated " << n << " bytes "
-                      << "(alignment: " << alignment << ", "
-                      << "offset: " << offset_ << ", "
-                      << "available: " << available() << ")\n";
-
-            // Step 5: Return aligned pointer
-            return ptr;
         }
+        auto end = high_resolution_clock::now();
 
-        // Step 6: Not enough space
-        std::cout << "  ❌ Arena allocation failed!\n"
-                  << "     Requested: " << n << " bytes\n"
-                  << "     Alignment: " << alignment << " bytes\n"
-                  << "     Available: " << space << " bytes\n";
-        throw std::bad_alloc();
+        auto duration = duration_cast<microseconds>(end - start);
+        double ops = 2.0 * num_threads * ops_per_thread;
+        std::cout << "  " << num_threads << " thread(s): " << duration.count() / 1000 << " ms ("
+                  << ops / std::max<long long>(duration.count(), 1) << " Mops/s)\n";
     }
+}
 
-    // TODO: Implement reset (deallocate all at once)
-    void reset() {
-        // Hints:
-        // - Set offset_ back to 0
-        // - Print reset message with how much was used
-        std::cout << "  🔄 Arena reset (was using " << offset_ << " bytes)\n";
-        offset_ = 0;
-    }
+// -----------------------------------------------------------------------------
+// Cross-thread benchmark: the allocator is shared by every thread and blocks are
+// freed by a different thread than the one that allocated them
+// -----------------------------------------------------------------------------
 
-    // TODO: Implement statistics methods
-    size_t used() const {
-        return offset_;
-    }
+// Timing every op with steady_clock would cost more than a pooled allocation,
+// so only every sample_every-th op is timed. Samples include one clock read, which
+// sets the floor of the reported latencies.
+class alignas(64) LatencySampler {
+public:
+    static constexpr unsigned sample_every = 8;
 
-    size_t available() const {
-        return size_ - offset_;
+    explicit LatencySampler(size_t expected_ops) {
+        samples_.reserve(expected_ops / sample_every + 1);
     }
 
-    size_t peak_usage() const {
-        return peak_usage_;
+    template <typename Op>
+    void time(Op&& op) {
+        if (++tick_ % sample_every != 0) {
+            op();
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        op();
+        auto end = std::chrono::steady_clock::now();
+        samples_.push_back(static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
     }
 
-    size_t total_size() const {
-        return size_;
+    const std::vector<uint32_t>& samples() const {
+        return samples_;
     }
-};
 
-// TODO: Implement ArenaAllocator adapter (so it works with STL containers)
-template <typename T>
-class ArenaAllocator {
 private:
-    Arena* arena_;
+    std::vector<uint32_t> samples_;
+    unsigned tick_ = 0;
+};
 
+// Single-producer/single-consumer ring used to hand blocks to another thread
+template <typename T>
+class SpscRing {
 public:
-    using value_type = T;
+    bool push(T* ptr) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == capacity) {
+            return false;
+        }
+        slots_[tail % capacity] = ptr;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
 
-    // TODO: Implement constructor
-    explicit ArenaAllocator(Arena* arena) : arena_(arena) {
-        // Just store the arena pointer
+    T* pop() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        T* ptr = slots_[head % capacity];
+        head_.store(head + 1, std::memory_order_release);
+        return ptr;
     }
 
-    // TODO: Implement rebind constructor
-    template <typename U>
-    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.get_arena()) {}
+private:
+    static constexpr size_t capacity = 1024;
+    std::array<T*, capacity> slots_{};
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
 
-    // TODO: Implement allocate
-    T* allocate(size_t n) {
-        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+// Runs body(thread_index, sampler) on num_threads threads; returns wall time and merged samples
+template <typename Body>
+std::pair<std::chrono::microseconds, std::vector<uint32_t>> run_threads(unsigned num_threads,
+                                                                        size_t ops_per_thread,
+                                                                        Body body) {
+    std::vector<LatencySampler> samplers;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        samplers.emplace_back(2 * ops_per_thread);
     }
 
-    // TODO: Implement deallocate
-    void deallocate(T*, size_t) noexcept {
-        // Hint: No-op! Arena deallocates everything at once
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&, t]() { body(t, samplers[t]); });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
     }
+    auto end = std::chrono::steady_clock::now();
 
-    // TODO: Implement rebind
-    template <typename U>
-    struct rebind {
-        using other = ArenaAllocator<U>;
-    };
-
-    Arena* get_arena() const {
-        return arena_;
+    std::vector<uint32_t> merged;
+    for (const auto& sampler : samplers) {
+        merged.insert(merged.end(), sampler.samples().begin(), sampler.samples().end());
     }
-
-    // Make ArenaAllocator<U> a friend so it can access arena_
-    template <typename U>
-    friend class ArenaAllocator;
-};
-
-// TODO: Implement comparison operators
-template <typename T, typename U>
-bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
-    // Hint: Two arena allocators are equal if they use the same arena
-    return a.get_arena() == b.get_arena();  // Replace this
-}
-
-template <typename T, typename U>
-bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
-    return a.get_arena() != b.get_arena();  // Replace this
+    return {std::chrono::duration_cast<std::chrono::microseconds>(end - start), merged};
 }
 
-// =============================================================================
-// Exercise 3: ⭐⭐⭐ Thread-Safe Pool Allocator
-// =============================================================================
-
-/*
- * GOAL: Make the pool allocator thread-safe for concurrent allocations
- *
- * Requirements:
- * - Multiple threads can allocate/deallocate concurrently
- * - Use fine-grained locking or lock-free techniques
- * - Maintain performance under contention
- */
-
-template <typename T, size_t PoolSize = 1024>
-class ThreadSafePoolAllocator {
-private:
-    // TODO: Add thread-safety primitives
-    // Options:
-    // 1. std::mutex for simple locking
-    // 2. std::atomic for lock-free free list
-    // 3. Thread-local pools for best performance
-
-    union Block {
-        T element;
-        Block* next;
-    };
-
-    struct Pool {
-        static constexpr size_t blocks_per_pool = PoolSize / sizeof(Block);
-        alignas(Block) char blocks[PoolSize];
-        Pool* next;
-    };
-    struct PoolState {
-        // ADD: Mutex for thread-safety
-        std::mutex mutex_;
-
-        Block* free_list_ = nullptr;
-        Pool* current_pool_ = nullptr;
-
-        // CHANGE: Make counters atomic
-        std::atomic<size_t> total_allocated_{0};
-        std::atomic<size_t> total_deallocated_{0};
-
-        ~PoolState() {
-            while (current_pool_) {
-                Pool* next = current_pool_->next;
-                ::operator delete(current_pool_);
-                current_pool_ = next;
-            }
-
-            // Print statistics
-            std::cout << "🏊 PoolAllocator destroyed\n";
-            std::cout << "   Allocated: " << total_allocated_ << "\n";
-            std::cout << "   Deallocated: " << total_deallocated_ << "\n";
-
-            // Check for leaks
-            size_t allocated = total_allocated_.load();
-            size_t deallocated = total_deallocated_.load();
-            if (allocated != deallocated) {
-                std::cout << "⚠️  Memory leak: " << (allocated - deallocated)
-                          << " objects not freed!\n";
-            }
+void print_cross_thread_row(const char* scenario, unsigned num_threads, double ops,
+                            std::chrono::microseconds elapsed, std::vector<uint32_t>& samples) {
+    auto percentile = [&](double p) -> uint32_t {
+        if (samples.empty()) {
+            return 0;
         }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
     };
 
-    // Add member variables
-    std::shared_ptr<PoolState> state_;
-
-public:
-    using value_type = T;
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+    std::cout << "  " << std::left << std::setw(11) << scenario << std::right << std::setw(3)
+              << num_threads << " thr: " << std::fixed << std::setprecision(2) << std::setw(8)
+              << ops / std::max<long long>(elapsed.count(), 1) << " Mops/s   p50 "
+              << std::setw(6) << percentile(0.50) << " ns   p99 " << std::setw(6)
+              << percentile(0.99) << " ns   p999 " << std::setw(7) << percentile(0.999)
+              << " ns\n";
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
 
-    // TODO: Implement thread-safe constructor
-    ThreadSafePoolAllocator() noexcept : state_(std::make_shared<PoolState>()) {
-        std::cout << "🔒 ThreadSafePoolAllocator: " << typeid(T).name() << "\n";
+// Thread-local churn: every thread frees its own blocks. make_alloc(t) supplies thread t's
+// allocator, so allocators that are not thread-safe can run with one instance per thread.
+template <typename MakeAllocator>
+void benchmark_thread_local_churn(MakeAllocator make_alloc, size_t ops_per_thread) {
+    using T = typename decltype(make_alloc(0u))::value_type;
+    constexpr int burst = 32;
+
+    const unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+    for (unsigned num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        auto [elapsed, samples] =
+            run_threads(num_threads, ops_per_thread, [&](unsigned t, LatencySampler& sampler) {
+                auto alloc = make_alloc(t);
+                T* ptrs[burst];
+                for (size_t i = 0; i < ops_per_thread; i += burst) {
+                    for (int j = 0; j < burst; ++j) {
+                        sampler.time([&] { ptrs[j] = alloc.allocate(1); });
+                    }
+                    for (int j = 0; j < burst; ++j) {
+                        sampler.time([&] { alloc.deallocate(ptrs[j], 1); });
+                    }
+                }
+            });
+        print_cross_thread_row("churn", num_threads, 2.0 * num_threads * ops_per_thread,
+                               elapsed, samples);
     }
+}
 
-    // TODO: Implement thread-safe destructor
-    ~ThreadSafePoolAllocator() = default;
+template <typename Allocator>
+void benchmark_cross_thread(const std::string& name, Allocator shared_alloc,
+                            size_t ops_per_thread = 100000) {
+    using T = typename Allocator::value_type;
+
+    const unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+
+    std::cout << name << ":\n";
+
+    // 1. Thread-local churn
+    benchmark_thread_local_churn([&](unsigned) { return shared_alloc; }, ops_per_thread);
+
+    // 2. Producer/consumer handoff: even threads allocate, odd threads free
+    for (unsigned num_threads = 2; num_threads <= max_threads; num_threads *= 2) {
+        std::vector<SpscRing<T>> rings(num_threads / 2);
+        auto [elapsed, samples] =
+            run_threads(num_threads, ops_per_thread, [&](unsigned t, LatencySampler& sampler) {
+                Allocator alloc = shared_alloc;
+                SpscRing<T>& ring = rings[t / 2];
+                if (t % 2 == 0) {
+                    for (size_t i = 0; i < ops_per_thread; ++i) {
+                        T* ptr = nullptr;
+                        sampler.time([&] { ptr = alloc.allocate(1); });
+                        *ptr = static_cast<T>(i);  // The "message"
+                        while (!ring.push(ptr)) {
+                            std::this_thread::yield();
+                        }
+                    }
+                } else {
+                    for (size_t i = 0; i < ops_per_thread; ++i) {
+                        T* ptr = nullptr;
+                        while (!(ptr = ring.pop())) {
+                            std::this_thread::yield();
+                        }
+                        sampler.time([&] { alloc.deallocate(ptr, 1); });
+                    }
+                }
+            });
+        print_cross_thread_row("handoff", num_threads, 1.0 * num_threads * ops_per_thread,
+                               elapsed, samples);
+    }
 
-    // TODO: Implement thread-safe allocate
-    T* allocate(size_t n) {
-        if (n != 1) {
-            return static_cast<T*>(::operator new(n * sizeof(T)));
+    // 3. All-to-all: swap fresh blocks into random shared slots and free whatever comes out
+    for (unsigned num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        std::vector<std::atomic<T*>> slots(num_threads * 64);
+        auto [elapsed, samples] =
+            run_threads(num_threads, ops_per_thread, [&](unsigned t, LatencySampler& sampler) {
+                Allocator alloc = shared_alloc;
+                std::minstd_rand rng(t + 1);
+                for (size_t i = 0; i < ops_per_thread; ++i) {
+                    T* ptr = nullptr;
+                    sampler.time([&] { ptr = alloc.allocate(1); });
+                    T* old = slots[rng() % slots.size()].exchange(ptr, std::memory_order_acq_rel);
+                    if (old) {
+                        sampler.time([&] { alloc.deallocate(old, 1); });
+                    }
+                }
+            });
+        for (auto& slot : slots) {
+            if (T* ptr = slot.load()) {
+                shared_alloc.deallocate(ptr, 1);
+            }
         }
+        double ops = 2.0 * num_threads * ops_per_thread - static_cast<double>(slots.size());
+        print_cross_thread_row("all-to-all", num_threads, ops, elapsed, samples);
+    }
+}
 
-        // LOCK THE MUTEX!
-        std::lock_guard<std::mutex> lock(state_->mutex_);
+void benchmark_arena_pattern(int frames = 1000) {
+    using namespace std::chrono;
 
-        if (!state_->free_list_) {
-            expand_pool();  // Called with lock held
-        }
+    std::cout << "\n=== Arena Pattern Benchmark ===\n";
 
-        Block* block = state_->free_list_;
-        state_->free_list_ = block->next;
-        state_->total_allocated_.fetch_add(1);  // Atomic increment
+    PerfCounters perf;
 
-        return reinterpret_cast<T*>(block);
-    }
+    // Without arena (default allocator)
+    perf.start();
+    auto start = high_resolution_clock::now();
+    {
+        for (int frame = 0; frame < frames; ++frame) {
+            std::vector<Particle> particles;
+            particles.resize(10000);
 
-    // TODO: Implement thread-safe deallocate
-    void deallocate(T* ptr, size_t n) {
-        // Hints:
-        // Option 1 (Simple): Lock mutex, return to free list, unlock
-        // Option 2 (Advanced): Use atomic CAS for lock-free deallocation
-        if (n != 1) {
-            ::operator delete(ptr);
-            return;
+            // Process particles...
+            for (auto& p : particles) {
+                p.x += p.vx;
+                p.y += p.vy;
+                p.z += p.vz;
+                p.life -= 0.016f;
+            }
+            // Vector destroyed, memory freed
         }
-
-        // LOCK THE MUTEX!
-        std::lock_guard<std::mutex> lock(state_->mutex_);
-
-        Block* block = reinterpret_cast<Block*>(ptr);
-        block->next = state_->free_list_;
-        state_->free_list_ = block;
-        state_->total_deallocated_.fetch_add(1);
     }
+    auto mid = high_resolution_clock::now();
+    PerfCounters::Reading default_counters = perf.stop();
 
-    template <typename U>
-    struct rebind {
-        using other = ThreadSafePoolAllocator<U, PoolSize>;
-    };
+    // With arena
+    perf.start();
+    {
+        // Starts small and grows to the frame's high-water mark; reset() keeps that block
+        Arena arena(64 * 1024, ArenaGrowthPolicy{});
 
-private:
-    //! MUST be called with state_->mutex_ held!
-    void expand_pool() {
-        Pool* new_pool = static_cast<Pool*>(::operator new(sizeof(Pool)));
-        new_pool->next = state_->current_pool_;
-        state_->current_pool_ = new_pool;
+        for (int frame = 0; frame < frames; ++frame) {
+            ArenaAllocator<Particle> alloc(&arena);
+            std::vector<Particle, ArenaAllocator<Particle>> particles(alloc);
+            particles.resize(10000);
 
-        Block* blocks = reinterpret_cast<Block*>(new_pool->blocks);
-        for (size_t i = 0; i < Pool::blocks_per_pool - 1; i++) {
-            blocks[i].next = &blocks[i + 1];
-        }
-        blocks[Pool::blocks_per_pool - 1].next = state_->free_list_;
-        state_->free_list_ = blocks;
+            // Process particles...
+            for (auto& p : particles) {
+                p.x += p.vx;
+                p.y += p.vy;
+                p.z += p.vz;
+                p.life -= 0.016f;
+            }
 
-        std::cout << "  📦 Pool expanded (thread-safe)\n";
+            arena.reset();  // Fast deallocation!
+        }
     }
-};
-
-// =============================================================================
-// Exercise 4: 🌟 BONUS - Tracking Allocator (Debugging)
-// =============================================================================
-
-/*
- * GOAL: Create a wrapper allocator that tracks all allocations
- *
- * Useful for:
- * - Finding memory leaks
- * - Profiling memory usage
- * - Understanding allocation patterns
- */
-
-template <typename T, typename BaseAllocator = std::allocator<T>>
-class TrackingAllocator {
-private:
-    BaseAllocator base_;
+    auto end = high_resolution_clock::now();
+    PerfCounters::Reading arena_counters = perf.stop();
 
-    // TODO: Add static tracking variables
-    static inline std::atomic<size_t> total_allocated_{0};
-    static inline std::atomic<size_t> total_freed_{0};
-    static inline std::atomic<size_t> allocation_count_{0};
-    static inline std::atomic<size_t> deallocation_count_{0};
-    static inline std::atomic<size_t> current_usage_{0};
-    static inline std::atomic<size_t> peak_usage_{0};
+    auto default_time = duration_cast<milliseconds>(mid - start);
+    auto arena_time = duration_cast<milliseconds>(end - mid);
 
-public:
-    using value_type = T;
+    // One op = one particle updated in one frame
+    const double particle_updates = 10000.0 * frames;
+    std::cout << "Default allocator: " << default_time.count() << " ms\n";
+    perf.print_per_op(default_counters, particle_updates);
+    std::cout << "Arena allocator: " << arena_time.count() << " ms\n";
+    perf.print_per_op(arena_counters, particle_updates);
+    std::cout << "Speedup: " << (double)default_time.count() / arena_time.count() << "x\n";
+}
 
-    TrackingAllocator() noexcept = default;
+// Same update, both layouts: AoS streams whole 32-byte Particles (color included), SoA only
+// the seven float arrays it needs and vectorises across particles
+void benchmark_particle_layout(size_t updates_per_size = 20000000) {
+    using namespace std::chrono;
 
-    template <typename U>
-    TrackingAllocator(const TrackingAllocator<U, BaseAllocator>&) noexcept {}
+    std::cout << "\n=== Particle Layout Benchmark (AoS vector<Particle> vs SoA "
+                 "ParticleSystem) ===\n";
+    std::cout << std::setw(10) << "particles" << std::setw(8) << "steps" << std::setw(14)
+              << "AoS ns/part" << std::setw(14) << "SoA ns/part" << std::setw(10) << "speedup"
+              << "\n";
+
+    constexpr float dt = 0.016f;
+    for (size_t count : {10000, 100000, 1000000, 10000000}) {
+        const int steps = static_cast<int>(std::max<size_t>(3, updates_per_size / count));
+        auto seed = [](size_t i, auto&& set) {
+            set(static_cast<float>(i % 1000), 0.0f, static_cast<float>(i % 7),
+                static_cast<float>(i % 5) * 0.1f, 1.0f, -0.5f, 1.0f + static_cast<float>(i % 100),
+                static_cast<int>(i));
+        };
+
+        double aos_seconds = 0;
+        float aos_sum = 0;
+        {
+            std::vector<Particle> particles(count);
+            for (size_t i = 0; i < count; ++i) {
+                seed(i, [&](float x, float y, float z, float vx, float vy, float vz, float life,
+                            int color) { particles[i] = {x, y, z, vx, vy, vz, life, color}; });
+            }
+            auto start = steady_clock::now();
+            for (int step = 0; step < steps; ++step) {
+                for (auto& p : particles) {
+                    p.x += p.vx * dt;
+                    p.y += p.vy * dt;
+                    p.z += p.vz * dt;
+                    p.life -= dt;
+                }
+            }
+            aos_seconds = duration<double>(steady_clock::now() - start).count();
+            for (const auto& p : particles) {
+                aos_sum += p.x + p.life;
+            }
+        }
 
-    // TODO: Implement allocate with tracking
-    T* allocate(size_t n) {
-        // Hints:
-        // 1. Call base_.allocate(n)
-        // 2. Update all statistics
-        // 3. Print allocation info (optional, can be verbose)
-        // 4. Return pointer
-        T* ptr = base_.allocate(n);
+        double soa_seconds = 0;
+        float soa_sum = 0;
+        {
+            Arena arena(ParticleSystem<>::bytes_for(count));
+            ParticleSystem<> particles(arena, count);
+            for (size_t i = 0; i < count; ++i) {
+                seed(i, [&](auto... fields) { particles.spawn(fields...); });
+            }
+            auto start = steady_clock::now();
+            for (int step = 0; step < steps; ++step) {
+                particles.update(dt);
+            }
+            soa_seconds = duration<double>(steady_clock::now() - start).count();
+            for (size_t i = 0; i < count; ++i) {
+                soa_sum += particles.x()[i] + particles.life()[i];
+            }
+        }
 
-        // Track statistics
-        size_t bytes = n * sizeof(T);
-        total_allocated_.fetch_add(bytes);
-        allocation_count_.fetch_add(1);
+        // Same arithmetic in the same order per particle: the results must agree
+        assert(std::abs(aos_sum - soa_sum) <= 1e-3f * std::abs(aos_sum));
+        (void)soa_sum;
+
+        const double per_particle = 1e9 / (static_cast<double>(count) * steps);
+        std::ios_base::fmtflags flags = std::cout.flags();
+        std::streamsize precision = std::cout.precision();
+        std::cout << std::setw(10) << count << std::setw(8) << steps << std::fixed
+                  << std::setprecision(3) << std::setw(14) << aos_seconds * per_particle
+                  << std::setw(14) << soa_seconds * per_particle << std::setprecision(2)
+                  << std::setw(9) << aos_seconds / soa_seconds << "x\n";
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+    }
+}
 
-        // update current and peak usage
-        size_t current = current_usage_.fetch_add(bytes) + bytes;
+// Particles/sec for every kernel this CPU can run: in cache (10k) and memory bound (10M)
+void benchmark_simd_kernels(size_t updates_per_size = 50000000) {
+    using namespace std::chrono;
 
-        // Update peak (lock-free)
-        size_t old_peak = peak_usage_.load();
-        while (current > old_peak && !peak_usage_.compare_exchange_weak(old_peak, current)) {
-            // Retry
+    std::cout << "\n=== SIMD Particle Kernels (detected: "
+              << ParticleKernels::name(ParticleKernels::detected()) << ") ===\n";
+    for (size_t count : {10000, 10000000}) {
+        Arena arena(ParticleSystem<>::bytes_for(count));
+        ParticleSystem<> particles(arena, count);
+        for (size_t i = 0; i < count; ++i) {
+            particles.spawn(static_cast<float>(i % 1000), 0.0f, 0.0f, 0.5f, 1.0f, -0.5f, 100.0f,
+                            static_cast<int>(i));
         }
 
-        return ptr;
+        const int steps = static_cast<int>(std::max<size_t>(3, updates_per_size / count));
+        std::cout << count << " particles x " << steps << " steps:\n";
+        for (SimdLevel level : ParticleKernels::levels) {
+            if (!ParticleKernels::supported(level)) {
+                std::cout << "   " << std::setw(7) << ParticleKernels::name(level)
+                          << " not supported here\n";
+                continue;
+            }
+            particles.update(0.0f, level);  // Warm up: pages faulted, lines cached if they fit
+            auto start = steady_clock::now();
+            for (int step = 0; step < steps; ++step) {
+                particles.update(0.016f, level);
+            }
+            double seconds = duration<double>(steady_clock::now() - start).count();
+            std::ios_base::fmtflags flags = std::cout.flags();
+            std::streamsize precision = std::cout.precision();
+            std::cout << "   " << std::setw(7) << ParticleKernels::name(level) << std::fixed
+                      << std::setprecision(0) << std::setw(8)
+                      << static_cast<double>(count) * steps / seconds / 1e6 << " M particles/s\n";
+            std::cout.flags(flags);
+            std::cout.precision(precision);
+        }
     }
+}
 
-    // TODO: Implement deallocate with tracking
-    void deallocate(T* ptr, size_t n) {
-        // Hints:
-        // 1. Update statistics
-        // 2. Print deallocation info (optional)
-        // 3. Call base_.deallocate(ptr, n)
+// parallel_for over entities and particles with 1 .. hardware_concurrency() workers. Both
+// loops stream memory, so the curve flattens once the memory bus is saturated.
+void benchmark_parallel_update(size_t entities = 1000000, size_t particle_count = 10000000,
+                               int frames = 10) {
+    using namespace std::chrono;
 
-        // Track statistics
-        size_t bytes = n * sizeof(T);
-        total_freed_.fetch_add(bytes);
-        deallocation_count_.fetch_add(1);
-        current_usage_.fetch_sub(bytes);
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "\n=== Parallel Update Scaling (" << entities << " entities, " << particle_count
+              << " particles, 1.." << hardware << " threads) ===\n";
 
-        // Call base allocator
-        base_.deallocate(ptr, n);
+    std::vector<Entity> world(entities);
+    for (size_t i = 0; i < entities; ++i) {
+        world[i] = Entity(static_cast<int>(i));
+        world[i].velocity_x = static_cast<float>(i % 13) - 6.0f;
+        world[i].velocity_y = static_cast<float>(i % 7) - 3.0f;
     }
+    Arena arena(ParticleSystem<>::bytes_for(particle_count));
+    ParticleSystem<> particles(arena, particle_count);
+    particles.resize(particle_count);
 
-    template <typename U>
-    struct rebind {
-        using other = TrackingAllocator<
-            U, typename std::allocator_traits<BaseAllocator>::template rebind_alloc<U>>;
+    std::vector<size_t> thread_counts;
+    for (size_t t = 1; t < hardware; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(hardware);
+
+    constexpr float dt = 0.016f;
+    constexpr size_t lane_block = 16;  // Particle chunks start on a cache line
+    const size_t blocks = (particle_count + lane_block - 1) / lane_block;
+    const ParticleUpdateKernel kernel = ParticleKernels::update();
+
+    struct Row {
+        size_t threads;
+        double entity_ms;
+        double particle_ms;
+        size_t steals;
+        size_t chunks;
     };
+    std::vector<Row> rows;
+    for (size_t threads : thread_counts) {
+        Row row{threads, 0, 0, 0, 0};
+        {
+            TaskScheduler scheduler(threads);
+            GrainTuner entity_grain;
+            GrainTuner particle_grain;
+            std::atomic<size_t> out_of_bounds{0};
+
+            // Moves entities and counts those outside the play area; each chunk gathers its
+            // offenders in worker scratch memory first, the way a real system would queue them
+            auto update_entities = [&](size_t first, size_t last, Arena& scratch) {
+                size_t* flagged = static_cast<size_t*>(
+                    scratch.allocate((last - first) * sizeof(size_t), alignof(size_t)));
+                size_t count = 0;
+                for (size_t i = first; i < last; ++i) {
+                    Entity& e = world[i];
+                    e.x += e.velocity_x * dt;
+                    e.y += e.velocity_y * dt;
+                    if (std::sqrt(e.x * e.x + e.y * e.y) > 1000.0f) {
+                        flagged[count++] = i;
+                    }
+                }
+                out_of_bounds.fetch_add(count, std::memory_order_relaxed);
+            };
+            auto update_particles = [&](size_t first, size_t last) {
+                size_t end = std::min(last * lane_block, particles.size());
+                kernel(particles.streams().slice(first * lane_block, end), dt);
+            };
+
+            // The first frame tunes the grains and warms the caches
+            scheduler.parallel_for(0, entities, update_entities, entity_grain);
+            scheduler.parallel_for(0, blocks, update_particles, particle_grain);
+
+            auto start = steady_clock::now();
+            for (int frame = 0; frame < frames; ++frame) {
+                scheduler.parallel_for(0, entities, update_entities, entity_grain);
+            }
+            auto middle = steady_clock::now();
+            for (int frame = 0; frame < frames; ++frame) {
+                scheduler.parallel_for(0, blocks, update_particles, particle_grain);
+            }
+            auto end = steady_clock::now();
 
-    // TODO: Implement static method to print statistics
-    // Static method to print statistics
-    static void print_stats() {
-        std::cout << "\n" << std::string(60, '=') << "\n";
-        std::cout << "📊 TrackingAllocator Statistics\n";
-        std::cout << std::string(60, '=') << "\n";
-
-        size_t total_alloc = total_allocated_.load();
-        size_t total_free = total_freed_.load();
-        size_t alloc_count = allocation_count_.load();
-        size_t dealloc_count = deallocation_count_.load();
-        size_t current = current_usage_.load();
-        size_t peak = peak_usage_.load();
-
-        std::cout << "Total allocated:     " << total_alloc << " bytes\n";
-        std::cout << "Total freed:         " << total_free << " bytes\n";
-        std::cout << "Current usage:       " << current << " bytes\n";
-        std::cout << "Peak usage:          " << peak << " bytes\n";
-        std::cout << "\n";
-        std::cout << "Allocation count:    " << alloc_count << "\n";
-        std::cout << "Deallocation count:  " << dealloc_count << "\n";
-
-        if (alloc_count > 0) {
-            std::cout << "Avg allocation size: " << (total_alloc / alloc_count) << " bytes\n";
-        }
-
-        std::cout << "\n";
-
-        // Check for leaks
-        if (current > 0) {
-            std::cout << "⚠️  MEMORY LEAK DETECTED!\n";
-            std::cout << "   " << current << " bytes still allocated\n";
-            std::cout << "   " << (alloc_count - dealloc_count) << " allocations not freed\n";
-        } else if (total_alloc == total_free) {
-            std::cout << "✅ No memory leaks detected\n";
+            row.entity_ms = duration<double, std::milli>(middle - start).count() / frames;
+            row.particle_ms = duration<double, std::milli>(end - middle).count() / frames;
+            row.steals = scheduler.steals();
+            row.chunks = scheduler.chunks_run();
         }
+        rows.push_back(row);
+    }
 
-        std::cout << std::string(60, '=') << "\n";
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "entities ms" << std::setw(9)
+              << "speedup" << std::setw(15) << "particles ms" << std::setw(9) << "speedup"
+              << std::setw(9) << "chunks" << std::setw(9) << "steals" << "\n";
+    for (const Row& row : rows) {
+        std::ios_base::fmtflags flags = std::cout.flags();
+        std::streamsize precision = std::cout.precision();
+        std::cout << std::fixed << std::setprecision(2) << std::setw(8) << row.threads
+                  << std::setw(14) << row.entity_ms << std::setw(8)
+                  << rows[0].entity_ms / row.entity_ms << "x" << std::setw(15) << row.particle_ms
+                  << std::setw(8) << rows[0].particle_ms / row.particle_ms << "x" << std::setw(9)
+                  << row.chunks << std::setw(9) << row.steals << "\n";
+        std::cout.flags(flags);
+        std::cout.precision(precision);
     }
+}
 
-    // TODO: Implement static method to reset statistics
-    static void reset_stats() {
-        total_allocated_.store(0);
-        total_freed_.store(0);
-        allocation_count_.store(0);
-        deallocation_count_.store(0);
-        current_usage_.store(0);
-        peak_usage_.store(0);
+// Entity storage at scale: create, iterate, random destroy + refill, iterate, destroy all.
+// The list's nodes come from the pool; destroying one needs its iterator, kept per entity
+// as a handle would be.
+void benchmark_entity_storage(size_t entities = 1000000, int passes = 10) {
+    using namespace std::chrono;
 
-        std::cout << "📊 Statistics reset\n";
-    }
+    std::cout << "\n=== Entity Storage Benchmark (" << entities
+              << " entities: std::list + PoolAllocator vs SlotMap) ===\n";
 
-    // Getters
-    static size_t get_total_allocated() {
-        return total_allocated_.load();
+    std::vector<size_t> victims(entities);
+    for (size_t i = 0; i < entities; ++i) {
+        victims[i] = i;
     }
-    static size_t get_total_freed() {
-        return total_freed_.load();
-    }
-    static size_t get_current_usage() {
-        return current_usage_.load();
-    }
-    static size_t get_peak_usage() {
-        return peak_usage_.load();
-    }
-    static size_t get_allocation_count() {
-        return allocation_count_.load();
+    std::shuffle(victims.begin(), victims.end(), std::mt19937(7));
+    victims.resize(entities / 2);
+
+    auto run = [&](const char* name, auto& storage, auto& refs, auto&& create, auto&& destroy,
+                   auto&& for_each) {
+        float sum = 0;
+        auto t0 = steady_clock::now();
+        for (size_t i = 0; i < entities; ++i) {
+            refs[i] = create(static_cast<int>(i));
+        }
+        auto t1 = steady_clock::now();
+        for (int p = 0; p < passes; ++p) {
+            for_each([&](Entity& e) { sum += e.x += 1.0f; });
+        }
+        auto t2 = steady_clock::now();
+        for (size_t i : victims) {
+            destroy(refs[i]);
+        }
+        for (size_t i : victims) {
+            refs[i] = create(static_cast<int>(i));
+        }
+        auto t3 = steady_clock::now();
+        for (int p = 0; p < passes; ++p) {
+            for_each([&](Entity& e) { sum += e.y += 1.0f; });
+        }
+        auto t4 = steady_clock::now();
+        for (size_t i = 0; i < entities; ++i) {
+            destroy(refs[i]);
+        }
+        auto t5 = steady_clock::now();
+        (void)storage;
+
+        auto ms = [](auto d) { return duration<double, std::milli>(d).count(); };
+        std::ios_base::fmtflags flags = std::cout.flags();
+        std::streamsize precision = std::cout.precision();
+        std::cout << std::setw(22) << name << std::fixed << std::setprecision(1) << std::setw(10)
+                  << ms(t1 - t0) << std::setw(10) << ms(t2 - t1) / passes << std::setw(10)
+                  << ms(t3 - t2) << std::setw(12) << ms(t4 - t3) / passes << std::setw(10)
+                  << ms(t5 - t4) << "  (sum " << std::setprecision(0) << sum << ")\n";
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+    };
+
+    std::cout << std::setw(22) << "ms" << std::setw(10) << "create" << std::setw(10) << "iterate"
+              << std::setw(10) << "churn" << std::setw(12) << "iterate'" << std::setw(10)
+              << "destroy" << "\n";
+    {
+        using EntityList = std::list<Entity, PoolAllocator<Entity, 64 * 1024>>;
+        EntityList list;
+        std::vector<EntityList::iterator> refs(entities);
+        run(
+            "pooled std::list", list, refs,
+            [&](int id) { return list.emplace(list.end(), id); },
+            [&](EntityList::iterator it) { list.erase(it); },
+            [&](auto&& fn) {
+                for (Entity& e : list) {
+                    fn(e);
+                }
+            });
     }
-    static size_t get_deallocation_count() {
-        return deallocation_count_.load();
+    {
+        SlotMap<Entity> slots;
+        std::vector<SlotHandle> refs(entities);
+        run(
+            "SlotMap", slots, refs, [&](int id) { return slots.create(id); },
+            [&](SlotHandle h) { slots.destroy(h); }, [&](auto&& fn) { slots.for_each(fn); });
     }
+}
 
-    // Make other template instances friends
-    template <typename U, typename A>
-    friend class TrackingAllocator;
-};
-
-// =============================================================================
-// Test Data Structures
-// =============================================================================
+// Random reads over a large arena: where 4K pages run out of dTLB reach
+void benchmark_arena_backing(size_t arena_bytes = 64 * 1024 * 1024, int lookups = 4000000) {
+    using namespace std::chrono;
 
-// Simple game entity for testing
-struct Entity {
-    int id;
-    float x, y, z;
-    float velocity_x, velocity_y;
-    int health;
+    std::cout << "\n=== Arena Backing Pages Benchmark (" << arena_bytes / (1024 * 1024)
+              << " MB, random reads) ===\n";
 
-    Entity(int i = 0) : id(i), x(0), y(0), z(0), velocity_x(0), velocity_y(0), health(100) {}
-};
+    auto run = [&](const std::string& name, PageProvider& pages) {
+        PerfCounters perf;
+        Arena arena(arena_bytes, pages);
+        const size_t count = arena_bytes / sizeof(Particle) - 1;
 
-// Particle for performance testing
-struct Particle {
-    float x, y, z;
-    float vx, vy, vz;
-    float life;
-    int color;
-};
+        auto start = high_resolution_clock::now();
+        Particle* particles = static_cast<Particle*>(
+            arena.allocate(count * sizeof(Particle), alignof(Particle)));
+        for (size_t i = 0; i < count; ++i) {
+            new (&particles[i]) Particle();
+            particles[i].life = static_cast<float>(i % 100);
+        }
+        auto filled = high_resolution_clock::now();
 
-// =============================================================================
-// Benchmark Functions
-// =============================================================================
+        perf.start();
+        std::minstd_rand rng(7);
+        float sum = 0;
+        for (int i = 0; i < lookups; ++i) {
+            sum += particles[rng() % count].life;
+        }
+        PerfCounters::Reading counters = perf.stop();
+        auto end = high_resolution_clock::now();
 
-template <typename Allocator>
-void benchmark_list_operations(const std::string& name, int iterations = 100000) {
-    using namespace std::chrono;
+        std::cout << name << ": fill " << duration_cast<milliseconds>(filled - start).count()
+                  << " ms, lookups " << duration_cast<milliseconds>(end - filled).count()
+                  << " ms (checksum " << sum << ")\n";
+        perf.print_per_op(counters, lookups);
+    };
 
-    auto start = high_resolution_clock::now();
+    run("Heap (::operator new)", PageProvider::heap());
 
-    {
-        std::list<int, Allocator> my_list;
+    MmapPageOptions small_pages;
+    small_pages.transparent_huge_pages = false;
+    MmapPageProvider mmap_4k(small_pages);
+    run("mmap, 4K pages", mmap_4k);
 
-        // Allocations
-        for (int i = 0; i < iterations; ++i) {
-            my_list.push_back(i);
-        }
+    MmapPageProvider mmap_thp;
+    run("mmap, transparent huge pages", mmap_thp);
 
-        // Mixed operations
-        for (int i = 0; i < iterations / 2; ++i) {
-            my_list.pop_front();
-        }
+    MmapPageOptions populated;
+    populated.populate = true;
+    MmapPageProvider mmap_thp_populate(populated);
+    run("mmap, THP + pre-faulted", mmap_thp_populate);
+}
 
-        for (int i = 0; i < iterations / 2; ++i) {
-            my_list.push_back(i);
-        }
+// One frame of mixed container work routed through a memory_resource
+size_t pmr_frame_workload(std::pmr::memory_resource* resource) {
+    std::pmr::vector<int> ints(resource);
+    std::pmr::string text(resource);
+    std::pmr::unordered_map<int, int> lookup(resource);
 
-        // Deallocations happen here when list is destroyed
+    for (int i = 0; i < 1000; ++i) {
+        ints.push_back(i);
+        lookup[i] = i * 2;
+        text += static_cast<char>('a' + i % 26);
     }
-
-    auto end = high_resolution_clock::now();
-    auto duration = duration_cast<milliseconds>(end - start);
-
-    std::cout << name << ": " << duration.count() << " ms\n";
+    return ints.size() + lookup.size() + text.size();
 }
 
-template <typename Allocator>
-void benchmark_vector_of_entities(const std::string& name, int count = 10000) {
+void benchmark_pmr_resources(int frames = 200) {
     using namespace std::chrono;
 
-    auto start = high_resolution_clock::now();
-
-    {
-        std::vector<Entity, Allocator> entities;
-        entities.reserve(count);
+    std::cout << "\n=== std::pmr Resource Benchmark ===\n";
 
-        for (int i = 0; i < count; ++i) {
-            entities.emplace_back(i);
+    size_t checksum = 0;
+    auto time_frames = [&](const std::string& name, auto&& run_frame) {
+        auto start = high_resolution_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            checksum += run_frame();
         }
+        auto duration = duration_cast<microseconds>(high_resolution_clock::now() - start);
+        std::cout << name << ": " << duration.count() << " μs\n";
+    };
 
-        // Simulate updates
-        for (auto& e : entities) {
-            e.x += e.velocity_x;
-            e.y += e.velocity_y;
-        }
-    }
+    time_frames("new_delete_resource", [] {
+        return pmr_frame_workload(std::pmr::new_delete_resource());
+    });
 
-    auto end = high_resolution_clock::now();
-    auto duration = duration_cast<microseconds>(end - start);
+    {
+        std::pmr::monotonic_buffer_resource monotonic(64 * 1024);
+        time_frames("monotonic_buffer_resource", [&] {
+            size_t result = pmr_frame_workload(&monotonic);
+            monotonic.release();
+            return result;
+        });
+    }
+    {
+        Arena arena(64 * 1024, ArenaGrowthPolicy{});
+        time_frames("ArenaResource", [&] {
+            ArenaResource<> resource(arena);  // Per frame, so top reclaim survives the reset
+            size_t result = pmr_frame_workload(&resource);
+            arena.reset();
+            return result;
+        });
+    }
+    {
+        std::pmr::unsynchronized_pool_resource pool;
+        time_frames("unsynchronized_pool_resource", [&] { return pmr_frame_workload(&pool); });
+    }
+    {
+        SmallObjectResource pool;
+        time_frames("SmallObjectResource", [&] { return pmr_frame_workload(&pool); });
+    }
+    {
+        std::pmr::synchronized_pool_resource pool;
+        time_frames("synchronized_pool_resource", [&] { return pmr_frame_workload(&pool); });
+    }
+    {
+        SynchronizedSmallObjectResource pool;
+        time_frames("SynchronizedSmallObjectResource",
+                    [&] { return pmr_frame_workload(&pool); });
+    }
 
-    std::cout << name << ": " << duration.count() << " μs\n";
+    std::cout << "(checksum " << checksum << ")\n";
 }
 
-void benchmark_arena_pattern(int frames = 1000) {
+// Entities churned through a CompactingPool until their slots are scattered, then iterated
+// before and after compact(): in address order (for_each) and in handle order
+void benchmark_compaction(size_t entities = 1000000, int churn_rounds = 3, int passes = 10) {
     using namespace std::chrono;
 
-    std::cout << "\n=== Arena Pattern Benchmark ===\n";
+    std::cout << "\n=== Compaction Benchmark (" << entities << " entities) ===\n";
 
-    // Without arena (default allocator)
-    auto start = high_resolution_clock::now();
-    {
-        for (int frame = 0; frame < frames; ++frame) {
-            std::vector<Particle> particles;
-            particles.resize(10000);
+    CompactingPool<Entity> pool;
+    std::vector<PoolHandle> handles;
+    for (size_t i = 0; i < entities; ++i) {
+        handles.push_back(pool.create(static_cast<int>(i)));
+    }
 
-            // Process particles...
-            for (auto& p : particles) {
-                p.x += p.vx;
-                p.y += p.vy;
-                p.z += p.vz;
-                p.life -= 0.016f;
-            }
-            // Vector destroyed, memory freed
+    // Each round destroys a random half and refills the holes, newest-freed first, ...
+    std::mt19937 rng(7);
+    for (int round = 0; round < churn_rounds; ++round) {
+        std::shuffle(handles.begin(), handles.end(), rng);
+        for (size_t i = 0; i < entities / 2; ++i) {
+            pool.destroy(handles[i]);
+            handles[i] = {};
+        }
+        for (size_t i = 0; i < entities / 2; ++i) {
+            handles[i] = pool.create(static_cast<int>(i));
         }
     }
-    auto mid = high_resolution_clock::now();
-
-    // With arena
-    {
-        Arena arena(10000 * sizeof(Particle) * 2);  // Enough for all frames
-
-        for (int frame = 0; frame < frames; ++frame) {
-            ArenaAllocator<Particle> alloc(&arena);
-            std::vector<Particle, ArenaAllocator<Particle>> particles(alloc);
-            particles.resize(10000);
-
-            // Process particles...
-            for (auto& p : particles) {
-                p.x += p.vx;
-                p.y += p.vy;
-                p.z += p.vz;
-                p.life -= 0.016f;
+    // ... and a final cull leaves every other slot empty on average
+    std::shuffle(handles.begin(), handles.end(), rng);
+    for (size_t i = 0; i < entities / 2; ++i) {
+        pool.destroy(handles[i]);
+    }
+    handles.erase(handles.begin(), handles.begin() + static_cast<ptrdiff_t>(entities / 2));
+    std::sort(handles.begin(), handles.end(),
+              [](PoolHandle a, PoolHandle b) { return a.index < b.index; });
+
+    auto measure = [&](const char* label) {
+        float sum = 0;
+        auto start = steady_clock::now();
+        for (int p = 0; p < passes; ++p) {
+            pool.for_each([&](Entity& e) { sum += e.x += 1.0f; });
+        }
+        auto middle = steady_clock::now();
+        for (int p = 0; p < passes; ++p) {
+            for (PoolHandle h : handles) {
+                sum += pool.get(h)->y += 1.0f;
             }
-
-            arena.reset();  // Fast deallocation!
         }
-    }
-    auto end = high_resolution_clock::now();
-
-    auto default_time = duration_cast<milliseconds>(mid - start);
-    auto arena_time = duration_cast<milliseconds>(end - mid);
+        auto end = steady_clock::now();
+        std::cout << label << ": for_each " << duration_cast<microseconds>(middle - start).count()
+                  << " μs, by handle " << duration_cast<microseconds>(end - middle).count()
+                  << " μs, fragmentation " << pool.fragmentation() << " (sum " << sum << ")\n";
+    };
 
-    std::cout << "Default allocator: " << default_time.count() << " ms\n";
-    std::cout << "Arena allocator: " << arena_time.count() << " ms\n";
-    std::cout << "Speedup: " << (double)default_time.count() / arena_time.count() << "x\n";
+    measure("Churned  ");
+    auto start = steady_clock::now();
+    pool.compact();
+    auto compact_time = duration_cast<microseconds>(steady_clock::now() - start);
+    measure("Compacted");
+    std::cout << "compact(): " << compact_time.count() << " μs for " << pool.size()
+              << " objects\n";
 }
 
 // =============================================================================
@@ -857,7 +1009,13 @@ void test_pool_allocator() {
 
     // TODO: Uncomment when implemented
     {
-        std::list<Entity, PoolAllocator<Entity>> entity_list;
+        // The list rebinds alloc to its node type; both share alloc's resource. Rebinding
+        // must not throw, so the node pool is only created by the first allocation.
+        static_assert(std::is_nothrow_constructible_v<PoolAllocator<Particle>,
+                                                      const PoolAllocator<Entity>&>);
+        PoolAllocator<Entity> alloc;
+        std::list<Entity, PoolAllocator<Entity>> entity_list(alloc);
+        assert(entity_list.get_allocator() == alloc);
 
         // Create entities
         for (int i = 0; i < 100; ++i) {
@@ -874,17 +1032,29 @@ void test_pool_allocator() {
         std::cout << "Removed 50 entities\n";
 
         // Add more (should reuse freed memory)
+        size_t pools_before = alloc.resource()->pool_count();
         for (int i = 100; i < 150; ++i) {
             entity_list.emplace_back(i);
         }
+        assert(alloc.resource()->pool_count() == pools_before);
 
         std::cout << "Added 50 more entities (reused memory)\n";
 
         // Print statistics
-        PoolAllocator<Entity> alloc;
         std::cout << "Total allocated: " << alloc.allocated_count() << "\n";
         std::cout << "Total deallocated: " << alloc.deallocated_count() << "\n";
         std::cout << "Current usage: " << alloc.current_usage() << "\n";
+
+        // A second container on the same resource reuses the first one's pools
+        entity_list.clear();
+        std::list<Entity, PoolAllocator<Entity>> second_list(alloc);
+        for (int i = 0; i < 100; ++i) {
+            second_list.emplace_back(i);
+        }
+        assert(alloc.resource()->pool_count() == pools_before);
+
+        std::cout << "Second list reused " << pools_before << " pool(s)\n";
+        alloc.resource()->print_stats();
     }
 
     std::cout << "\n✅ Pool Allocator test complete!\n";
@@ -929,6 +1099,58 @@ void test_arena_allocator() {
             std::cout << "After reset, arena used: " << arena.used() << " bytes\n";
         }
 
+        // In-place growth: std::vector leaves each outgrown buffer behind, while try_extend
+        // keeps growing the top allocation where it is
+        arena.reset();
+        {
+            ArenaAllocator<int> int_alloc(&arena);
+            std::vector<int, ArenaAllocator<int>> vec(int_alloc);
+            for (int i = 0; i < 1000; ++i) {
+                vec.push_back(i);
+            }
+            std::cout << "\nvector<int> grown to 1000 by push_back: " << arena.used()
+                      << " bytes used\n";
+        }
+        std::cout << "After the vector is destroyed: " << arena.used()
+                  << " bytes used (its top buffer was reclaimed)\n";
+
+        arena.reset();
+        {
+            ArenaAllocator<int> int_alloc(&arena);
+            size_t capacity = 1;
+            int* data = int_alloc.allocate(capacity);
+            for (size_t size = 0; size < 1000; ++size) {
+                if (size == capacity) {
+                    bool extended = int_alloc.try_extend(data, capacity, capacity * 2);
+                    assert(extended);
+                    (void)extended;
+                    capacity *= 2;
+                }
+                data[size] = static_cast<int>(size);
+            }
+            std::cout << "Buffer grown to 1000 with try_extend: " << arena.used()
+                      << " bytes used (capacity " << capacity << ")\n";
+            assert(arena.used() == capacity * sizeof(int) + Arena::guard_bytes);
+            int_alloc.deallocate(data, capacity);
+        }
+        assert(arena.used() == 0);
+
+        // A container that outlives a reset must not reclaim the newer allocation now sitting
+        // at its old address: the allocator remembers the arena epoch it allocated in
+        {
+            using IntVector = std::vector<int, ArenaAllocator<int>>;
+            auto stale = std::make_unique<IntVector>(100, 0, ArenaAllocator<int>(&arena));
+            arena.reset();
+            IntVector fresh(100, 1, ArenaAllocator<int>(&arena));
+            assert(fresh.data() == stale->data());
+            size_t used = arena.used();
+            stale.reset();
+            assert(arena.used() == used && fresh.back() == 1);
+            std::cout << "Stale vector destroyed after reset: " << arena.used()
+                      << " bytes still used by the new one\n";
+            (void)used;
+        }
+
         std::cout << "Peak usage: " << arena.peak_usage() << " bytes\n";
     }
 
@@ -936,6 +1158,82 @@ void test_arena_allocator() {
     // Removed the "not implemented" message since you've implemented it!
 }
 
+void test_growable_arena() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 6: ⭐⭐ Growable (Chained) Arena\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    for (ArenaResetPolicy policy : {ArenaResetPolicy::keep_largest, ArenaResetPolicy::retain_all}) {
+        // Deliberately tiny first block: requests chain on new blocks instead of failing.
+        // The tracing flavour logs every allocation, growth and reset.
+        TracingArena arena(256, ArenaGrowthPolicy{2, 4096, policy});
+
+        size_t blocks_before_reset = 0;
+        for (int round = 0; round < 2; ++round) {
+            for (int i = 0; i < 20; ++i) {
+                arena.allocate(200);
+            }
+            arena.allocate(10000);  // Larger than the cap: gets a block of its own
+
+            std::cout << "Round " << round << ": used " << arena.used() << " bytes in "
+                      << arena.block_count() << " blocks (" << arena.total_size()
+                      << " bytes owned)\n";
+            blocks_before_reset = arena.block_count();
+            arena.reset();
+        }
+
+        [[maybe_unused]] size_t expected_blocks =
+            policy == ArenaResetPolicy::keep_largest ? 1 : blocks_before_reset;
+        std::cout << "After reset: " << arena.block_count() << " block(s), " << arena.total_size()
+                  << " bytes owned\n";
+        assert(arena.block_count() == expected_blocks);
+        assert(arena.used() == 0);
+    }
+
+    std::cout << "\n✅ Growable arena test complete!\n";
+}
+
+void test_arena_scopes() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 7: ⭐⭐ Arena Markers and Scoped Rewind\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    {
+        Arena arena(4096, ArenaGrowthPolicy{});
+
+        // Request-level data that must survive the nested phases
+        ArenaAllocator<int> int_alloc(&arena);
+        std::vector<int, ArenaAllocator<int>> request_ids(int_alloc);
+        request_ids.reserve(16);
+        size_t request_bytes = arena.used();
+
+        for (int iteration = 0; iteration < 100; ++iteration) {
+            ArenaScope parse_scope(arena);
+            std::vector<Entity, ArenaAllocator<Entity>> tokens{ArenaAllocator<Entity>(&arena)};
+            tokens.reserve(32);
+
+            {
+                ArenaScope temp_scope(arena);  // Nested scratch inside the parse phase
+                arena.allocate(512);
+            }
+
+            request_ids.push_back(iteration % 16);
+            if (request_ids.size() == 16) {
+                request_ids.clear();
+            }
+        }
+
+        std::cout << "Request data: " << request_bytes << " bytes\n";
+        std::cout << "Used after 100 scoped iterations: " << arena.used() << " bytes\n";
+        std::cout << "Peak usage: " << arena.peak_usage() << " bytes\n";
+
+        assert(arena.used() == request_bytes);
+        assert(arena.peak_usage() < request_bytes + 2048);
+    }
+
+    std::cout << "\n✅ Arena scope test complete!\n";
+}
+
 void test_thread_safety() {
     std::cout << "\n" << std::string(60, '=') << "\n";
     std::cout << "TEST 3: ⭐⭐⭐ Thread-Safe Pool Allocator\n";
@@ -970,25 +1268,1266 @@ void test_thread_safety() {
         std::cout << "All threads completed successfully!\n";
     }
 
+    // Rebinding (list nodes, allocate_shared control blocks) must not throw
+    static_assert(std::is_nothrow_constructible_v<ThreadSafePoolAllocator<Particle>,
+                                                  const ThreadSafePoolAllocator<int>&>);
+
+    // Short-lived threads retire their magazines on exit; the counts survive in the totals
+    {
+        ThreadSafePoolAllocator<int> alloc;
+        for (int round = 0; round < 50; ++round) {
+            std::thread([&alloc]() {
+                int* value = alloc.allocate(1);
+                alloc.deallocate(value, 1);
+            }).join();
+        }
+        std::cout << "Magazines left after 50 short-lived threads: " << alloc.magazine_count()
+                  << "\n";
+        assert(alloc.magazine_count() == 0);
+    }
+
     std::cout << "\n✅ Thread-safe allocator test complete!\n";
 
     // std::cout << "❌ Implement ThreadSafePoolAllocator first!\n";
 }
 
-void run_benchmarks() {
+void test_lock_free_pool() {
     std::cout << "\n" << std::string(60, '=') << "\n";
-    std::cout << "BENCHMARKS\n";
+    std::cout << "TEST 4: 🌟 Lock-Free Pool Allocator (cross-thread stress)\n";
     std::cout << std::string(60, '=') << "\n";
 
-    std::cout << "\n--- List Operations Benchmark ---\n";
-    benchmark_list_operations<std::allocator<int>>("Default allocator");
-    benchmark_list_operations<PoolAllocator<int>>("Pool allocator");
+    {
+        struct Payload {
+            uint64_t stamp;
+            uint64_t check;
+        };
+
+        const int num_threads = 8;
+        const int ops_per_thread = 50000;
+        constexpr size_t num_slots = 64;
+
+        // Threads swap freshly allocated objects into shared slots and free whatever they
+        // swapped out, so most frees happen on a different thread than the allocation.
+        LockFreePoolAllocator<Payload, 64> alloc;
+        std::atomic<Payload*> slots[num_slots] = {};
+        std::atomic<int> corrupted{0};
+
+        auto verify_and_free = [&](Payload* p) {
+            if (p->check != ~p->stamp) {
+                corrupted.fetch_add(1);
+            }
+            alloc.deallocate(p, 1);
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&, t]() {
+                uint64_t rng = 0x9E3779B97F4A7C15ull * (t + 1);
+                for (int i = 0; i < ops_per_thread; ++i) {
+                    rng ^= rng << 13;
+                    rng ^= rng >> 7;
+                    rng ^= rng << 17;
+
+                    Payload* p = alloc.allocate(1);
+                    p->stamp = rng;
+                    p->check = ~rng;
+
+                    if (Payload* old = slots[rng % num_slots].exchange(p)) {
+                        verify_and_free(old);
+                    }
+                }
+            });
+        }
+
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (auto& slot : slots) {
+            if (Payload* p = slot.exchange(nullptr)) {
+                verify_and_free(p);
+            }
+        }
+
+        std::cout << "Allocated: " << alloc.allocated_count() << "\n";
+        std::cout << "Deallocated: " << alloc.deallocated_count() << "\n";
+        std::cout << "Blocks carved: " << alloc.capacity() << "\n";
+        std::cout << "Corrupted objects: " << corrupted.load() << "\n";
+
+        assert(corrupted.load() == 0);
+        assert(alloc.current_usage() == 0);
+        assert(alloc.allocated_count() == size_t{num_threads} * ops_per_thread);
+    }
+
+    {
+        // Rebound copies share the group: nodes and control blocks freed through any copy
+        // go back to the right pool, and rebinding back compares equal to the original.
+        // Rebinding only copies the group, so it can't throw.
+        static_assert(std::is_nothrow_constructible_v<LockFreePoolAllocator<double, 64>,
+                                                      const LockFreePoolAllocator<int, 64>&>);
+        LockFreePoolAllocator<int, 64> ints;
+        LockFreePoolAllocator<double, 64> doubles_a(ints);
+        LockFreePoolAllocator<double, 64> doubles_b(ints);
+        assert(doubles_a == doubles_b);
+        using IntAllocator = LockFreePoolAllocator<int, 64>;
+        assert(IntAllocator(doubles_a) == ints);
+        assert(ints != IntAllocator{});
+
+        double* d = doubles_a.allocate(1);
+        doubles_b.deallocate(d, 1);
+        assert(doubles_a.current_usage() == 0);
+
+        auto shared = std::allocate_shared<int>(ints, 42);
+        assert(*shared == 42);
+        shared.reset();
+
+        std::list<int, IntAllocator> values(ints);
+        for (int i = 0; i < 100; ++i) {
+            values.push_back(i);
+        }
+        std::list<int, IntAllocator> copy(values);
+        values.clear();
+        assert(copy.size() == 100 && copy.back() == 99);
+        std::cout << "Rebound copies share pools: allocate_shared and std::list round-trip\n";
+    }
+
+    std::cout << "\n✅ Lock-free pool stress test complete!\n";
+}
+
+void test_small_object_allocator() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 5: 🌟 Small-Object Allocator (size classes)\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    {
+        // One backing store shared by containers of unrelated element types
+        auto pool = std::make_shared<SmallObjectPool>();
+
+        std::list<Entity, SmallObjectAllocator<Entity>> entities{
+            SmallObjectAllocator<Entity>(pool)};
+        using ParticleEntry = std::pair<const int, Particle>;
+        std::map<int, Particle, std::less<int>, SmallObjectAllocator<ParticleEntry>> particles{
+            SmallObjectAllocator<ParticleEntry>(pool)};
+        std::vector<int, SmallObjectAllocator<int>> small_ints{SmallObjectAllocator<int>(pool)};
+
+        for (int i = 0; i < 1000; ++i) {
+            entities.emplace_back(i);
+            particles.emplace(i, Particle{});
+            if (i < 32) {
+                small_ints.push_back(i);  // Grows through 4..128 byte buffers
+            }
+        }
+        for (int i = 0; i < 500; ++i) {
+            entities.pop_front();
+            particles.erase(i);
+        }
+
+        assert(entities.get_allocator() == small_ints.get_allocator());
+        pool->print_stats();
+    }
+
+    std::cout << "\n✅ Small-object allocator test complete!\n";
+}
+
+void test_pmr_adapters() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 8: 🌟 std::pmr Adapters\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    {
+        // One arena behind three unrelated pmr container types
+        Arena arena(16 * 1024, ArenaGrowthPolicy{});
+        ArenaResource<> resource(arena);
+
+        std::pmr::vector<Entity> entities(&resource);
+        std::pmr::string name("arena-backed string that is too long for SSO", &resource);
+        std::pmr::unordered_map<int, Particle> particles(&resource);
+
+        for (int i = 0; i < 100; ++i) {
+            entities.emplace_back(i);
+            particles[i] = Particle{};
+        }
+
+        std::cout << "Arena used by pmr containers: " << arena.used() << " bytes in "
+                  << arena.block_count() << " block(s)\n";
+        assert(entities.get_allocator().resource()->is_equal(resource));
+    }
+
+    {
+        SmallObjectResource resource;
+        {
+            std::pmr::list<Entity> entities(&resource);
+            std::pmr::map<int, int> lookup(&resource);
+            for (int i = 0; i < 100; ++i) {
+                entities.emplace_back(i);
+                lookup[i] = i;
+            }
+        }
+        resource.pool()->print_stats();
+    }
+
+    std::cout << "\n✅ std::pmr adapter test complete!\n";
+}
+
+void test_tracking_allocator() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 9: 🌟 Tracking Allocator (sharded counters)\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    using Tracked = TrackingAllocator<Entity>;
+    Tracked tracked(TrackingDomain::create("entities"));
+
+    {
+        const int num_threads = 4;
+        const int per_thread = 5000;
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([=]() {
+                Tracked alloc = tracked;
+                std::vector<Entity*> live;
+                for (int i = 0; i < per_thread; ++i) {
+                    live.push_back(alloc.allocate(1));
+                }
+                for (Entity* e : live) {
+                    alloc.deallocate(e, 1);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        assert(tracked.get_allocation_count() == size_t{num_threads} * per_thread);
+        assert(tracked.get_current_usage() == 0);
+        // The peak is only published every peak_refresh_bytes a shard allocates, so it can
+        // trail one thread's high-water mark by that much
+        assert(tracked.get_peak_usage() + TrackingCounters::peak_refresh_bytes >=
+               per_thread * sizeof(Entity));
+    }
+
+    // A thread_local destroyed after the thread's slot lease frees through the overflow
+    // shard instead of a slot that may already belong to another thread
+    {
+        static std::atomic<size_t> late_slot{0};
+        struct LateFree {
+            Tracked* alloc = nullptr;
+            Entity* entity = nullptr;
+            ~LateFree() {
+                if (entity) {
+                    alloc->deallocate(entity, 1);
+                }
+                late_slot = ThreadSlots::current();
+            }
+        };
+
+        std::thread([&tracked]() {
+            thread_local LateFree late;  // Constructed before the lease, so destroyed after it
+            late.alloc = &tracked;
+            late.entity = tracked.allocate(1);
+        }).join();
+
+        assert(late_slot == ThreadSlots::overflow_slot);
+        assert(tracked.get_current_usage() == 0);
+    }
+
+    tracked.print_stats();
+
+    // Profiling: size and lifetime histograms plus sampled call sites, exported as JSON/CSV
+    {
+        TrackingAllocator<char> alloc(TrackingDomain::create("profiling"));
+        alloc.set_sampling(8, true);
+
+        std::vector<std::pair<char*, size_t>> live;
+        for (size_t i = 0; i < 256; ++i) {
+            size_t bytes = size_t{8} << (i % 8);  // 8 B .. 1 KiB
+            live.emplace_back(alloc.allocate(bytes), bytes);
+            if (live.size() > 16) {
+                alloc.deallocate(live.front().first, live.front().second);
+                live.erase(live.begin());
+            }
+        }
+        for (auto [ptr, bytes] : live) {
+            alloc.deallocate(ptr, bytes);
+        }
+        alloc.set_sampling(0);
+
+        std::ostringstream json_out;
+        alloc.write_json(json_out);
+        std::ostringstream csv_out;
+        alloc.write_csv(csv_out);
+        std::string json = json_out.str();
+        std::string csv = csv_out.str();
+
+        std::cout << "JSON export: " << json.size() << " bytes, CSV export: "
+                  << std::count(csv.begin(), csv.end(), '\n') << " rows\n";
+        std::cout << json.substr(0, 200) << "...\n";
+        assert(json.find("\"lifetime_histogram_ns\": [{") != std::string::npos);
+    }
+
+    std::cout << "\n✅ Tracking allocator test complete!\n";
+}
+
+void test_tracking_domains() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 10: 🌟 Tracking Domains (per-instance statistics)\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    auto physics = TrackingDomain::create("physics");
+    auto ui = TrackingDomain::create("ui");
+
+    {
+        // The list allocates _List_node<int>, not int; the rebound allocator keeps the domain
+        std::list<int, TrackingAllocator<int>> bodies{TrackingAllocator<int>(physics)};
+        for (int i = 0; i < 1000; ++i) {
+            bodies.push_back(i);
+        }
+
+        std::map<int, std::string, std::less<int>,
+                 TrackingAllocator<std::pair<const int, std::string>>>
+            labels{TrackingAllocator<std::pair<const int, std::string>>(ui)};
+        for (int i = 0; i < 100; ++i) {
+            labels.emplace(i, "label");
+        }
+
+        assert(physics->snapshot().allocation_count == 1000);
+        assert(physics->snapshot().current_usage >= 1000 * sizeof(int));
+        assert(ui->snapshot().allocation_count == 100);
+
+        // Rebound copies compare equal and share one set of counters
+        TrackingAllocator<double> rebound(bodies.get_allocator());
+        assert(rebound == bodies.get_allocator());
+        assert(rebound.domain() == physics);
+        assert(rebound != TrackingAllocator<double>(ui));
+
+        TrackingDomain::print_all();
+    }
+
+    assert(physics->snapshot().current_usage == 0);
+    assert(ui->snapshot().current_usage == 0);
+    physics->print_stats();
+
+    // Domain names are free text; the CSV export quotes them per RFC 4180
+    {
+        auto odd = TrackingDomain::create("hud, \"debug\" overlay");
+        TrackingAllocator<int> alloc(odd);
+        alloc.deallocate(alloc.allocate(1), 1);
+
+        std::ostringstream csv;
+        odd->write_csv(csv, false);
+        std::cout << csv.str();
+        assert(csv.str().rfind("total,\"hud, \"\"debug\"\" overlay\",0,1,", 0) == 0);
+    }
+
+    std::cout << "\n✅ Tracking domain test complete!\n";
+}
+
+// kB value of a /proc/self/status or smaps_rollup field, 0 if unavailable
+size_t read_proc_kb(const char* file, const std::string& field) {
+    std::ifstream in(file);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind(field + ":", 0) == 0) {
+            return std::stoul(line.substr(field.size() + 1));
+        }
+    }
+    return 0;
+}
+
+void test_page_providers() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 11: 🌟 Page Providers (mmap, huge pages, trim)\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    constexpr size_t MiB = 1024 * 1024;
+
+    // Transparent huge pages: 2 MB-aligned mapping + MADV_HUGEPAGE
+    {
+        MmapPageProvider pages;
+        {
+            ArenaGrowthPolicy policy;
+            policy.trim_on_reset = true;
+            Arena arena(8 * MiB, policy, pages);
+            assert(pages.mapped_bytes() % 4096 == 0);  // Block rounded up to whole pages
+            assert(arena.total_size() >= 8 * MiB);
+
+            size_t rss_before = read_proc_kb("/proc/self/status", "VmRSS");
+            char* data = static_cast<char*>(arena.allocate(6 * MiB));
+            std::fill(data, data + 6 * MiB, 'x');
+            size_t rss_touched = read_proc_kb("/proc/self/status", "VmRSS");
+            size_t huge_kb = read_proc_kb("/proc/self/smaps_rollup", "AnonHugePages");
+
+            arena.reset();  // trim_on_reset: MADV_DONTNEED everything past the bump pointer
+            size_t rss_trimmed = read_proc_kb("/proc/self/status", "VmRSS");
+            assert(pages.released_bytes() >= 6 * MiB);
+
+            std::cout << "RSS: " << rss_before << " kB -> " << rss_touched << " kB (touched, "
+                      << huge_kb << " kB on huge pages) -> " << rss_trimmed << " kB (trimmed)\n";
+
+            // Still usable after trimming; released pages come back zeroed (the block's
+            // first page also holds its header, so it is kept)
+            char* again = static_cast<char*>(arena.allocate(MiB));
+            assert(again[MiB - 1] == 0);
+            (void)again;
+        }
+        pages.print_stats();
+        assert(pages.mapped_bytes() == 0);
+    }
+
+    // MAP_HUGETLB needs reserved pages; without them the provider falls back to THP
+    {
+        MmapPageOptions options;
+        options.huge_pages = true;
+        options.populate = true;
+        MmapPageProvider pages(options);
+        {
+            Arena arena(4 * MiB, pages);
+            assert(pages.mapped_bytes() % MmapPageProvider::huge_page_size == 0);
+            static_cast<char*>(arena.allocate(MiB))[0] = 1;
+        }
+        {
+            // Chunks above a huge page keep their alignment whichever path maps them
+            FixedBlockPool pool(sizeof(Entity), alignof(Entity), 8 * MiB, pages);
+            std::vector<void*> blocks(1000);
+            for (void*& block : blocks) {
+                block = pool.allocate();
+            }
+            for (void* block : blocks) {
+                pool.deallocate(block);
+            }
+            assert(pool.trim() == 8 * MiB);
+        }
+        pages.print_stats();
+    }
+
+    // Pools: every chunk is whole pages from the provider
+    {
+        MmapPageProvider pages;
+        {
+            auto resource = std::make_shared<PoolResource>(4096, pages);
+            std::list<Entity, PoolAllocator<Entity>> entities{PoolAllocator<Entity>(resource)};
+            for (int i = 0; i < 1000; ++i) {
+                entities.emplace_back(i);
+            }
+            assert(pages.mapped_bytes() == resource->pool_count() * 4096);
+            resource->print_stats();
+        }
+        assert(pages.mapped_bytes() == 0);
+    }
+
+    std::cout << "\n✅ Page provider test complete!\n";
+}
+
+// Blocks allocated on every (fake) node, then freed by threads on other nodes
+template <typename Allocator>
+void check_numa_routing(const char* name) {
+    constexpr size_t num_threads = 4;
+    constexpr size_t blocks_per_thread = 5000;
+
+    Allocator alloc;
+    std::vector<std::vector<Entity*>> blocks(num_threads);
+
+    auto on_threads = [](auto body) {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < num_threads; ++t) {
+            threads.emplace_back(body, t);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    };
+
+    // Producers: every block comes from the allocating thread's node
+    std::atomic<size_t> foreign{0};
+    on_threads([&](size_t t) {
+        size_t node = NumaTopology::current_node() % alloc.node_count();
+        for (size_t i = 0; i < blocks_per_thread; ++i) {
+            Entity* entity = alloc.allocate(1);
+            foreign += alloc.node_of(entity) != node;
+            blocks[t].push_back(entity);
+        }
+    });
+    assert(foreign == 0);
+
+    // Consumers: new threads (so new node assignments) free another thread's blocks
+    on_threads([&](size_t t) {
+        for (Entity* entity : blocks[(t + 1) % num_threads]) {
+            alloc.deallocate(entity, 1);
+        }
+    });
+
+    // Exited threads have drained their magazines; every block must be home
+    size_t misplaced = alloc.misplaced_blocks();
+    std::cout << name << ": " << alloc.node_count() << " nodes, " << misplaced
+              << " blocks on the wrong node\n";
+    assert(misplaced == 0);
+    (void)misplaced;
+}
+
+void test_numa_pools() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 12: 🌟 NUMA-Aware Thread-Safe Pools\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    std::cout << "Real topology: " << NumaTopology::node_count() << " node(s), this thread on node "
+              << NumaTopology::current_node() << "\n";
+
+    // Whatever the machine, a pool created now has one sub-pool per real node
+    {
+        ThreadSafePoolAllocator<Entity, 64 * 1024> alloc;
+        assert(alloc.node_count() == NumaTopology::node_count());
+        Entity* entity = alloc.allocate(1);
+        assert(alloc.node_of(entity) == NumaTopology::current_node());
+        alloc.deallocate(entity, 1);
+    }
+
+    // Chunks smaller than a page are rounded up to one, so mbind can place every chunk:
+    // on a multi-node machine each must be resident on the node it was bound to
+    {
+        ThreadSafePoolAllocator<Entity> alloc;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&alloc]() {
+                std::vector<Entity*> entities(200);
+                for (Entity*& entity : entities) {
+                    entity = alloc.allocate(1);
+                }
+                for (Entity* entity : entities) {
+                    alloc.deallocate(entity, 1);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        size_t misplaced = alloc.misplaced_chunks();
+        std::cout << "Chunks: " << alloc.reserved_bytes() / NumaTopology::page_size()
+                  << " page(s), " << misplaced << " resident on the wrong node\n";
+        assert(alloc.reserved_bytes() % NumaTopology::page_size() == 0);
+        assert(misplaced == 0);
+        (void)misplaced;
+    }
+
+    // Fake two-node machine: threads are assigned nodes round-robin
+    NumaTopology::set_fake_nodes(2);
+    check_numa_routing<ThreadSafePoolAllocator<Entity, 64 * 1024>>("Thread-local magazines");
+    check_numa_routing<ThreadSafePoolAllocator<Entity, 4096, 0>>("Mutex per call");
+    NumaTopology::set_fake_nodes(0);
+
+    std::cout << "\n✅ NUMA pool test complete!\n";
+}
+
+template <typename Allocator>
+void check_bulk_allocation(const char* name) {
+    constexpr size_t count = 10000;
+
+    Allocator alloc;
+    std::vector<Particle*> particles(count);
+    alloc.allocate_n(particles);
+
+    // Every block distinct and writable
+    std::vector<Particle*> sorted = particles;
+    std::sort(sorted.begin(), sorted.end());
+    assert(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+    for (Particle* p : particles) {
+        p->life = 1.0f;
+    }
+
+    alloc.deallocate_n(particles);
+
+    // The freed batch is reused, mixed with single-object calls
+    Particle* single = alloc.allocate(1);
+    alloc.allocate_n(std::span<Particle*>(particles).first(count / 2));
+    alloc.deallocate(single, 1);
+    alloc.deallocate_n(std::span<Particle* const>(particles).first(count / 2));
+
+    std::cout << name << ": " << count << " blocks in one call\n";
+}
+
+void test_bulk_allocation() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 13: 🌟 Bulk allocate_n / deallocate_n\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    check_bulk_allocation<PoolAllocator<Particle, 64 * 1024>>("PoolAllocator");
+    check_bulk_allocation<ThreadSafePoolAllocator<Particle, 64 * 1024>>("Thread-local magazines");
+    check_bulk_allocation<ThreadSafePoolAllocator<Particle, 64 * 1024, 0>>("Mutex per call");
+    check_bulk_allocation<LockFreePoolAllocator<Particle>>("Lock-free (tagged head)");
+
+    // One pool, one stats update per batch: the counters still match per-object calls
+    {
+        PoolAllocator<Particle, 64 * 1024> alloc;
+        std::vector<Particle*> particles(1000);
+        alloc.allocate_n(particles);
+        assert(alloc.allocated_count() == 1000 && alloc.current_usage() == 1000);
+        alloc.deallocate_n(particles);
+        assert(alloc.current_usage() == 0);
+    }
+
+    // Running out of memory halfway through a batch hands nothing out and loses no block
+    {
+        struct OneChunkPages final : PageProvider {
+            bool used = false;
+            void* allocate_pages(size_t bytes, size_t alignment) override {
+                if (std::exchange(used, true)) {
+                    throw std::bad_alloc();
+                }
+                return heap().allocate_pages(bytes, alignment);
+            }
+            void deallocate_pages(void* ptr, size_t bytes, size_t alignment) noexcept override {
+                heap().deallocate_pages(ptr, bytes, alignment);
+            }
+        } pages;
+
+        FixedBlockPool pool(sizeof(Particle), alignof(Particle), 4096, pages);
+        std::vector<void*> blocks(10000);  // More than one chunk holds
+        bool threw = false;
+        try {
+            pool.allocate_n(std::span<void*>(blocks));
+        } catch (const std::bad_alloc&) {
+            threw = true;
+        }
+        assert(threw && pool.current_usage() == 0 && pool.pool_count() == 1);
+        (void)threw;
+
+        // Every block of the one chunk is back on the free list, so the chunk counts as empty
+        size_t released = pool.trim();
+        assert(released == 4096 && pool.pool_count() == 0);
+        std::cout << "Failed batch returned its blocks: trim() released " << released
+                  << " bytes\n";
+    }
+
+    // Freed by a thread on another (fake) node: each block still goes home
+    NumaTopology::set_fake_nodes(2);
+    {
+        ThreadSafePoolAllocator<Particle, 64 * 1024> alloc;
+        std::vector<Particle*> particles(5000);
+        std::span<Particle*> all(particles);
+        std::thread([&] { alloc.allocate_n(all.first(2500)); }).join();
+        std::thread([&] { alloc.allocate_n(all.last(2500)); }).join();  // Other node
+        std::thread([&] { alloc.deallocate_n(particles); }).join();
+        assert(alloc.misplaced_blocks() == 0);
+        std::cout << "Cross-node deallocate_n: " << alloc.misplaced_blocks()
+                  << " blocks on the wrong node\n";
+    }
+    NumaTopology::set_fake_nodes(0);
+
+    std::cout << "\n✅ Bulk allocation test complete!\n";
+}
+
+void test_pool_trimming() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 14: 🌟 Pool Trimming (giving empty chunks back)\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    constexpr size_t spike = 20000;
+    std::vector<Particle*> particles(spike);
+
+    // Load spike, then everything but a few survivors is freed
+    {
+        PoolAllocator<Particle, 4096> alloc;
+        alloc.allocate_n(particles);
+        size_t peak = alloc.resource()->reserved_bytes();
+
+        std::span<Particle*> all(particles);
+        alloc.deallocate_n(all.subspan(10));
+        size_t released = alloc.trim();
+        size_t after = alloc.resource()->reserved_bytes();
+        std::cout << "PoolAllocator: " << peak << " bytes reserved at peak, " << released
+                  << " released, " << after << " kept for 10 live particles\n";
+        assert(after + released == peak && after > 0 && after <= 10 * 4096);
+
+        // Survivors untouched, pool still usable
+        alloc.allocate_n(all.subspan(10));
+        alloc.deallocate_n(all);
+
+        // shrink_to keeps (up to) the requested amount around for the next spike
+        alloc.shrink_to(64 * 1024);
+        assert(alloc.resource()->reserved_bytes() == 64 * 1024);
+        alloc.trim();
+        assert(alloc.resource()->reserved_bytes() == 0);
+    }
+
+    // Decommit: pages go back to the OS, the address range stays for the next spike
+    {
+        MmapPageProvider pages;
+        {
+            auto resource = std::make_shared<PoolResource>(64 * 1024, pages);
+            PoolAllocator<Particle> alloc(resource);
+            alloc.allocate_n(particles);
+            alloc.deallocate_n(particles);
+
+            size_t mapped = pages.mapped_bytes();
+            size_t decommitted = alloc.trim(PoolTrimMode::decommit);
+            std::cout << "Decommitted " << decommitted << " of " << mapped
+                      << " mapped bytes; the mapping stays for reuse\n";
+            assert(resource->reserved_bytes() == 0 && pages.mapped_bytes() == mapped);
+            assert(pages.released_bytes() > 0);
+
+            alloc.allocate_n(particles);  // Reuses the decommitted chunks
+            assert(pages.mapped_bytes() == mapped);
+            alloc.deallocate_n(particles);
+            pages.print_stats();
+        }
+        assert(pages.mapped_bytes() == 0);
+    }
+
+    // Thread-safe pool: a spike on worker threads, trimmed in the background afterwards
+    {
+        ThreadSafePoolAllocator<Particle, 64 * 1024> alloc;
+        std::thread([&] {
+            alloc.allocate_n(particles);
+            alloc.deallocate_n(particles);
+        }).join();
+        size_t peak = alloc.reserved_bytes();
+
+        BackgroundTrimmer<ThreadSafePoolAllocator<Particle, 64 * 1024>> trimmer(
+            alloc, std::chrono::milliseconds(5), 64 * 1024);
+        while (trimmer.passes() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::cout << "ThreadSafePoolAllocator: " << peak << " bytes reserved at peak, "
+                  << alloc.reserved_bytes() << " after background trim\n";
+        assert(alloc.reserved_bytes() <= 64 * 1024);
+        assert(trimmer.released_bytes() == peak - alloc.reserved_bytes());
+    }
+
+    std::cout << "\n✅ Pool trimming test complete!\n";
+}
+
+void test_compacting_pool() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 15: 🌟 Compacting Handle Pool (defragmentation)\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    CompactingPool<Entity, 256> pool;
+    std::vector<PoolHandle> handles;
+    for (int i = 0; i < 1000; ++i) {
+        handles.push_back(pool.create(i));
+    }
+
+    // Punch holes: every other entity goes, then a few newcomers land in the holes
+    for (size_t i = 0; i < handles.size(); i += 2) {
+        pool.destroy(handles[i]);
+    }
+    PoolHandle stale = handles[0];
+    for (int i = 0; i < 100; ++i) {
+        handles.push_back(pool.create(1000 + i));
+    }
+    assert(pool.get(stale) == nullptr);  // Slot reused, generation moved on
+    (void)stale;
+    std::cout << "Before compact: " << pool.size() << " live in " << pool.capacity()
+              << " slots, fragmentation " << pool.fragmentation() << "\n";
+
+    // A cached raw pointer kept valid by the relocation hook
+    PoolHandle watched = handles[501];
+    Entity* cached = pool.get(watched);
+    size_t moves = 0;
+    pool.set_relocation_hook([&](PoolHandle handle, Entity* from, Entity* to) {
+        moves++;
+        if (handle == watched) {
+            assert(from == cached);
+            cached = to;
+        }
+    });
+
+    size_t moved = pool.compact();
+    std::cout << "After compact:  " << pool.size() << " live in " << pool.capacity()
+              << " slots, fragmentation " << pool.fragmentation() << ", " << moved << " moved\n";
+    assert(moves == pool.size() && moved == pool.size());
+    assert(pool.fragmentation() == 0.0 && pool.capacity() == 768);
+    assert(cached == pool.get(watched) && cached->id == 501);
+
+    // Every surviving handle still reaches its entity
+    for (size_t i = 1; i < 1000; i += 2) {
+        assert(pool.get(handles[i])->id == static_cast<int>(i));
+    }
+
+    // Address order now follows handle order
+    std::sort(handles.begin(), handles.end(),
+              [](PoolHandle a, PoolHandle b) { return a.index < b.index; });
+    std::vector<int> by_handle;
+    for (PoolHandle h : handles) {
+        if (Entity* e = pool.get(h)) {
+            by_handle.push_back(e->id);
+        }
+    }
+    std::vector<int> by_address;
+    pool.for_each([&](Entity& e) { by_address.push_back(e.id); });
+    assert(by_address == by_handle);
+    (void)moved;
+
+    std::cout << "\n✅ Compacting pool test complete!\n";
+}
+
+// Guard violations are recorded instead of aborting, so the test can provoke them
+size_t guard_reports = 0;
+
+void record_guard_report(const char* what, const void* ptr) {
+    std::cout << "   guard: " << what << "\n";
+    guard_reports++;
+}
+
+void test_allocator_guards() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 16: 🌟 Allocator Guards (canaries, poisoning, double free)\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    AllocatorGuards::Handler previous = AllocatorGuards::set_handler(&record_guard_report);
+    std::cout << (IMPSTUDY_ASAN ? "ASan build: freed memory and red zones are poisoned\n"
+                                : "No ASan: canaries and fill patterns only\n");
+
+    {
+        auto resource =
+            std::make_shared<PoolResource>(4096, PageProvider::heap(), PoolGuardMode::checked);
+        PoolAllocator<Entity> alloc(resource);
+
+        // Containers work as usual on a checked pool
+        {
+            std::list<Entity, PoolAllocator<Entity>> entities(alloc);
+            for (int i = 0; i < 1000; ++i) {
+                entities.emplace_back(i);
+            }
+        }
+
+        // Double free: reported and skipped, the free list stays intact
+        Entity* entity = alloc.allocate(1);
+        alloc.deallocate(entity, 1);
+        alloc.deallocate(entity, 1);
+        assert(guard_reports == 1);
+        assert(alloc.current_usage() == 0);
+
+        // Raw 40-byte blocks, so the red zone starts exactly at bytes[40]
+        FixedBlockPool& buffers = resource->pool_for(40, alignof(std::max_align_t));
+        char* bytes = static_cast<char*>(buffers.allocate());
+        if (IMPSTUDY_ASAN) {
+            // Any access past the buffer or to a freed block faults immediately
+            assert(!AllocatorGuards::is_poisoned(bytes + 39));
+            assert(AllocatorGuards::is_poisoned(bytes + 40));
+            buffers.deallocate(bytes);
+            assert(AllocatorGuards::is_poisoned(bytes));
+        } else {
+            bytes[40] = 1;  // One byte past the end
+            buffers.deallocate(bytes);
+            assert(guard_reports == 2);
+
+            bytes[0] = 1;  // Write through the dangling pointer; caught on reuse (LIFO)
+            void* reused = buffers.allocate();
+            assert(reused == bytes && guard_reports == 3);
+            buffers.deallocate(reused);
+        }
+    }
+
+    {
+        CheckedArena arena(4096);
+        char* data = static_cast<char*>(arena.allocate(100));
+        std::fill(data, data + 100, 'x');
+        if (IMPSTUDY_ASAN) {
+            // Red zone and the unused tail are poisoned, the allocation itself is not
+            assert(!AllocatorGuards::is_poisoned(data + 99));
+            assert(AllocatorGuards::is_poisoned(data + 100));
+            assert(AllocatorGuards::is_poisoned(data + 1000));
+        } else {
+            size_t before = guard_reports;
+            data[100] = 'y';  // Overflow into the red zone; found when the arena resets
+            arena.reset();
+            assert(guard_reports == before + 1);
+            (void)before;
+        }
+        arena.reset();
+
+        // Scoped scratch memory is poisoned again once the scope ends
+        char* scratch = nullptr;
+        {
+            ArenaScope<CheckedArena> scope(arena);
+            scratch = static_cast<char*>(arena.allocate(256));
+            scratch[0] = 1;
+        }
+        assert(!IMPSTUDY_ASAN || AllocatorGuards::is_poisoned(scratch));
+        (void)scratch;
+    }
+
+    AllocatorGuards::set_handler(previous);
+    std::cout << guard_reports << " violation(s) caught\n";
+    std::cout << "\n✅ Allocator guard test complete!\n";
+}
+
+void test_particle_system() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 17: ⭐⭐ Struct-of-Arrays Particle System\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    Arena arena(ParticleSystem<>::bytes_for(1000));
+    ParticleSystem<> particles(arena, 1000);
+    assert(particles.capacity() >= 1000 && particles.capacity() % 16 == 0);
+    assert(arena.used() <= ParticleSystem<>::bytes_for(1000));
+
+    // Every stream starts on its own cache line
+    for (const void* stream : {static_cast<const void*>(particles.x().data()),
+                               static_cast<const void*>(particles.vz().data()),
+                               static_cast<const void*>(particles.color().data())}) {
+        assert(reinterpret_cast<uintptr_t>(stream) % ParticleSystem<>::alignment == 0);
+        (void)stream;
+    }
+
+    // The SoA kernel matches the AoS loop particle for particle
+    std::vector<Particle> reference;
+    for (int i = 0; i < 1000; ++i) {
+        Particle p{static_cast<float>(i), 0.0f, 0.0f, 1.0f, 2.0f, -1.0f,
+                   static_cast<float>(i % 10) * 0.01f, i};
+        reference.push_back(p);
+        particles.spawn(p.x, p.y, p.z, p.vx, p.vy, p.vz, p.life, p.color);
+    }
+    for (int step = 0; step < 3; ++step) {
+        particles.update(0.016f);
+        for (auto& p : reference) {
+            p.x += p.vx * 0.016f;
+            p.y += p.vy * 0.016f;
+            p.z += p.vz * 0.016f;
+            p.life -= 0.016f;
+        }
+    }
+    for (size_t i = 0; i < reference.size(); ++i) {
+        assert(std::abs(particles.x()[i] - reference[i].x) < 1e-4f);
+        assert(std::abs(particles.vz()[i] - reference[i].vz) < 1e-4f);
+        assert(std::abs(particles.life()[i] - reference[i].life) < 1e-4f);
+        assert(particles.color()[i] == reference[i].color);
+    }
+
+    // Lives were 0.00..0.09: those at or below 3 * 0.016 are gone, the rest kept their data
+    size_t expected_dead = static_cast<size_t>(
+        std::count_if(reference.begin(), reference.end(), [](const Particle& p) {
+            return p.life <= 0.0f;
+        }));
+    size_t dead = particles.remove_dead();
+    std::cout << "Removed " << dead << " expired particles, " << particles.size() << " left\n";
+    assert(dead == expected_dead && particles.size() == 1000 - dead);
+    for (size_t i = 0; i < particles.size(); ++i) {
+        const Particle& p = reference[static_cast<size_t>(particles.color()[i])];
+        assert(particles.life()[i] > 0.0f && std::abs(particles.x()[i] - p.x) < 1e-4f);
+        (void)p;
+    }
+    (void)expected_dead;
+
+    particles.resize(particles.capacity());
+    assert(particles.life().back() == 0.0f);
+    bool threw = false;
+    try {
+        particles.spawn(0, 0, 0, 0, 0, 0, 1, 0);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    assert(threw);
+    (void)threw;
+
+    std::cout << "\n✅ Particle system test complete!\n";
+}
+
+void test_simd_kernels() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 18: ⭐⭐⭐ SIMD Particle Kernels (runtime dispatch)\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    std::cout << "Detected: " << ParticleKernels::name(ParticleKernels::detected()) << "\n";
+    assert(ParticleKernels::supported(SimdLevel::scalar));
+
+    // Odd counts cover the 4/8/16-wide bodies and their tails
+    for (size_t count : {1, 7, 15, 17, 1000, 1003}) {
+        Arena arena(ParticleSystem<>::bytes_for(count) * 2);
+        ParticleSystem<> expected(arena, count);
+        ParticleSystem<> actual(arena, count);
+        for (ParticleSystem<>* system : {&expected, &actual}) {
+            for (size_t i = 0; i < count; ++i) {
+                float f = static_cast<float>(i);
+                system->spawn(f, -f, f * 0.5f, 1.0f + f * 0.01f, -2.0f, 0.25f, 10.0f + f, 0);
+            }
+        }
+
+        if (actual.capacity() > count) {
+            actual.life().data()[count] = -1.0f;
+        }
+
+        for (SimdLevel level : ParticleKernels::levels) {
+            if (!ParticleKernels::supported(level)) {
+                continue;
+            }
+            expected.update(0.016f, SimdLevel::scalar);
+            actual.update(0.016f, level);
+            for (size_t i = 0; i < count; ++i) {
+                assert(std::abs(actual.x()[i] - expected.x()[i]) < 1e-3f);
+                assert(std::abs(actual.y()[i] - expected.y()[i]) < 1e-3f);
+                assert(std::abs(actual.z()[i] - expected.z()[i]) < 1e-3f);
+                assert(actual.life()[i] == expected.life()[i]);
+            }
+        }
+        // Kernels stop at size(): the padding past the last particle is never written
+        assert(actual.capacity() == count || actual.life().data()[count] == -1.0f);
+    }
+
+    for (SimdLevel level : ParticleKernels::levels) {
+        std::cout << "   " << ParticleKernels::name(level) << ": "
+                  << (level == SimdLevel::scalar           ? "reference"
+                      : ParticleKernels::supported(level) ? "matches scalar"
+                                                          : "not supported")
+                  << "\n";
+    }
+    std::cout << "\n✅ SIMD kernel test complete!\n";
+}
+
+void test_task_scheduler() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 19: ⭐⭐⭐ Work-Stealing Scheduler (parallel_for)\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    TaskScheduler scheduler(4);
+    assert(scheduler.worker_count() == 4);
+
+    // Fixed grain: every index is visited exactly once
+    {
+        std::vector<int> hits(100000, 0);
+        scheduler.parallel_for(0, hits.size(), [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                hits[i]++;
+            }
+        }, 1000);
+        assert(std::all_of(hits.begin(), hits.end(), [](int h) { return h == 1; }));
+    }
+
+    // Auto-tuned grain, learnt over a few calls of the same loop
+    {
+        GrainTuner tuner;
+        std::vector<float> values(200000, 1.0f);
+        for (int frame = 0; frame < 3; ++frame) {
+            scheduler.parallel_for(0, values.size(), [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    values[i] = std::sqrt(values[i] + 1.0f);
+                }
+            }, tuner);
+        }
+        assert(tuner.tuned());
+        size_t grain = tuner.grain(values.size(), scheduler.worker_count());
+        assert(grain >= 1 && grain <= values.size());
+        std::cout << "Tuned grain: " << grain << " elements (" << tuner.ns_per_element()
+                  << " ns each)\n";
+        (void)grain;
+    }
+
+    // Per-worker scratch arenas, released after every chunk
+    {
+        std::atomic<long long> total{0};
+        scheduler.parallel_for(0, 10000, [&](size_t first, size_t last, Arena& scratch) {
+            long long* squares = static_cast<long long*>(
+                scratch.allocate((last - first) * sizeof(long long), alignof(long long)));
+            long long sum = 0;
+            for (size_t i = first; i < last; ++i) {
+                squares[i - first] = static_cast<long long>(i) * static_cast<long long>(i);
+                sum += squares[i - first];
+            }
+            total.fetch_add(sum, std::memory_order_relaxed);
+        });
+        assert(total == 9999LL * 10000 * 19999 / 6);
+    }
+
+    // Nested loops share the same workers
+    {
+        std::atomic<size_t> inner_elements{0};
+        scheduler.parallel_for(0, 8, [&](size_t first, size_t last) {
+            for (size_t outer = first; outer < last; ++outer) {
+                scheduler.parallel_for(0, 1000, [&](size_t a, size_t b) {
+                    inner_elements.fetch_add(b - a, std::memory_order_relaxed);
+                }, 100);
+            }
+        }, 1);
+        assert(inner_elements == 8000);
+    }
+
+    // An exception ends the loop and reaches the caller; the scheduler stays usable
+    {
+        bool caught = false;
+        try {
+            scheduler.parallel_for(0, 10000, [](size_t first, size_t last) {
+                if (first <= 5000 && 5000 < last) {
+                    throw std::runtime_error("bad element");
+                }
+            }, 100);
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        assert(caught);
+        (void)caught;
+    }
+
+    // Callers from outside the scheduler take turns
+    {
+        std::atomic<size_t> visited{0};
+        std::vector<std::thread> callers;
+        for (int c = 0; c < 3; ++c) {
+            callers.emplace_back([&]() {
+                scheduler.parallel_for(0, 5000, [&](size_t first, size_t last) {
+                    visited.fetch_add(last - first, std::memory_order_relaxed);
+                }, 250);
+            });
+        }
+        for (auto& caller : callers) {
+            caller.join();
+        }
+        assert(visited == 15000);
+    }
+
+    std::cout << scheduler.chunks_run() << " chunks run, " << scheduler.steals()
+              << " stolen\n";
+    std::cout << "\n✅ Task scheduler test complete!\n";
+}
+
+void test_slot_map() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "TEST 20: 🌟 Slot Map (generational handles, dense storage)\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    SlotMap<Entity> entities;
+    std::vector<SlotHandle> handles;
+    for (int i = 0; i < 100; ++i) {
+        handles.push_back(entities.create(i));
+    }
+    assert(entities.size() == 100 && entities.get(handles[42])->id == 42);
+
+    // Destroying from the middle moves the last entity into the hole; handles don't notice
+    assert(entities.destroy(handles[10]));
+    assert(entities.values()[10].id == 99);
+    assert(entities.get(handles[99])->id == 99 && entities.handle_at(10) == handles[99]);
+
+    // The stale handle is caught by its generation alone, even once the slot is reused
+    assert(!entities.contains(handles[10]) && entities.get(handles[10]) == nullptr);
+    assert(!entities.destroy(handles[10]));
+    SlotHandle reused = entities.create(1000);
+    assert(reused.index == handles[10].index && reused.generation != handles[10].generation);
+    assert(entities.get(handles[10]) == nullptr && entities.get(reused)->id == 1000);
+    assert(!entities.contains(SlotHandle{}));
+    (void)reused;
+
+    // Iteration is a linear walk over exactly the live entities
+    std::vector<int> ids;
+    entities.for_each([&](Entity& e) { ids.push_back(e.id); });
+    assert(ids.size() == entities.size());
+    assert(&entities.values().back() - &entities.values().front() ==
+           static_cast<ptrdiff_t>(entities.size() - 1));
+
+    // Non-trivial types are moved into holes and destroyed properly
+    SlotMap<std::string> names;
+    SlotHandle first = names.create("a fairly long string that will not fit in SSO");
+    SlotHandle second = names.create("another string that is long enough to allocate");
+    names.destroy(first);
+    assert(*names.get(second) == "another string that is long enough to allocate");
+    names.clear();
+    assert(names.empty() && names.get(second) == nullptr);
+    (void)second;
+
+    // A throwing constructor hands out no slot: fresh slots are dropped, reused ones stay free
+    struct Fussy {
+        explicit Fussy(bool fail) {
+            if (fail) {
+                throw std::runtime_error("rejected");
+            }
+        }
+    };
+    SlotMap<Fussy> fussy;
+    auto create_failing = [&fussy]() {
+        try {
+            fussy.create(true);
+            assert(false && "create() should have thrown");
+        } catch (const std::runtime_error&) {
+        }
+    };
+    SlotHandle kept = fussy.create(false);
+    create_failing();  // Would have taken a fresh slot
+    assert(fussy.size() == 1 && fussy.slot_count() == 1);
+    SlotHandle freed = fussy.create(false);
+    fussy.destroy(freed);
+    create_failing();  // Would have reused freed's slot
+    assert(fussy.size() == 1 && fussy.slot_count() == 2 && fussy.contains(kept));
+    assert(fussy.create(false).index == freed.index);
+    (void)kept;
+
+    // Handles of the two handle-based containers don't mix
+    static_assert(!std::is_convertible_v<PoolHandle, SlotHandle>);
+    static_assert(!std::is_convertible_v<SlotHandle, PoolHandle>);
+
+    std::cout << entities.size() << " live entities in " << entities.slot_count() << " slots\n";
+    std::cout << "\n✅ Slot map test complete!\n";
+}
+
+void run_benchmarks() {
+    std::cout << "\n" << std::string(60, '=') << "\n";
+    std::cout << "BENCHMARKS\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    std::cout << "\n--- List Operations Benchmark ---\n";
+    benchmark_list_operations<std::allocator<int>>("Default allocator");
+    benchmark_list_operations<PoolAllocator<int>>("Pool allocator");
+    benchmark_list_operations<LockFreePoolAllocator<int>>("Lock-free pool allocator");
+    benchmark_list_operations<SmallObjectAllocator<int>>("Small-object allocator");
+    benchmark_list_operations<TrackingAllocator<int>>("Tracking allocator (std::allocator)");
+
+    std::cout << "\n--- Thread Scaling Benchmark (shared pool) ---\n";
+    benchmark_thread_scaling<std::allocator<int>>("std::allocator");
+    benchmark_thread_scaling<TrackingAllocator<int>>("TrackingAllocator (std::allocator)");
+    benchmark_thread_scaling<ThreadSafePoolAllocator<int, 64 * 1024, 0>>("Mutex per call");
+    benchmark_thread_scaling<ThreadSafePoolAllocator<int, 64 * 1024>>("Thread-local magazines");
+    benchmark_thread_scaling<LockFreePoolAllocator<int>>("Lock-free (tagged head)");
+
+    std::cout << "\n--- Cross-Thread Benchmark (churn / handoff / all-to-all) ---\n";
+    benchmark_cross_thread("std::allocator", std::allocator<int>());
+    benchmark_cross_thread("TrackingAllocator (std::allocator)", TrackingAllocator<int>());
+    benchmark_cross_thread("Mutex per call", ThreadSafePoolAllocator<int, 64 * 1024, 0>());
+    benchmark_cross_thread("Thread-local magazines", ThreadSafePoolAllocator<int, 64 * 1024>());
+    benchmark_cross_thread("Lock-free (tagged head)", LockFreePoolAllocator<int>());
+    {
+        SynchronizedSmallObjectResource resource;
+        benchmark_cross_thread("pmr SynchronizedSmallObjectResource",
+                               std::pmr::polymorphic_allocator<int>(&resource));
+    }
+
+    // Single-threaded allocators only run churn, with one instance per thread; handoff and
+    // all-to-all free blocks on another thread, which they do not support.
+    std::cout << "(handoff / all-to-all skipped below: one instance per thread)\n";
+    {
+        const unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+        std::vector<PoolAllocator<int>> pools(max_threads);
+        std::vector<SmallObjectAllocator<int>> small_objects(max_threads);
+        // Churn frees in FIFO order, so the arenas never reclaim and must be growable
+        std::vector<Arena> arenas;
+        for (unsigned t = 0; t < max_threads; ++t) {
+            arenas.emplace_back(64 * 1024, ArenaGrowthPolicy{});
+        }
+
+        std::cout << "PoolAllocator:\n";
+        benchmark_thread_local_churn([&](unsigned t) { return pools[t]; }, 100000);
+        std::cout << "SmallObjectAllocator:\n";
+        benchmark_thread_local_churn([&](unsigned t) { return small_objects[t]; }, 100000);
+        std::cout << "ArenaAllocator:\n";
+        benchmark_thread_local_churn(
+            [&](unsigned t) { return ArenaAllocator<int>(&arenas[t]); }, 100000);
+    }
+
+    std::cout << "\n--- Bulk Allocation Benchmark (10,000 particles per frame) ---\n";
+    benchmark_bulk_allocation<PoolAllocator<Particle, 64 * 1024>>("Pool allocator");
+    benchmark_bulk_allocation<ThreadSafePoolAllocator<Particle, 64 * 1024, 0>>("Mutex per call");
+    benchmark_bulk_allocation<ThreadSafePoolAllocator<Particle, 64 * 1024>>(
+        "Thread-local magazines");
+    benchmark_bulk_allocation<LockFreePoolAllocator<Particle>>("Lock-free (tagged head)");
 
     std::cout << "\n--- Vector of Entities Benchmark ---\n";
     benchmark_vector_of_entities<std::allocator<Entity>>("Default allocator");
 
     // TODO: Uncomment when implemented
     benchmark_arena_pattern();
+    benchmark_particle_layout();
+    benchmark_simd_kernels();
+    benchmark_parallel_update();
+    benchmark_arena_backing();
+    benchmark_pmr_resources();
+    benchmark_compaction();
+    benchmark_entity_storage();
 
     std::cout << "\n";
 }
@@ -1005,7 +2544,24 @@ int main() {
         // Run tests
         test_pool_allocator();
         test_arena_allocator();
+        test_growable_arena();
+        test_arena_scopes();
         test_thread_safety();
+        test_lock_free_pool();
+        test_small_object_allocator();
+        test_pmr_adapters();
+        test_tracking_allocator();
+        test_tracking_domains();
+        test_page_providers();
+        test_numa_pools();
+        test_bulk_allocation();
+        test_pool_trimming();
+        test_compacting_pool();
+        test_allocator_guards();
+        test_particle_system();
+        test_simd_kernels();
+        test_task_scheduler();
+        test_slot_map();
 
         // Run performance benchmarks
         run_benchmarks();
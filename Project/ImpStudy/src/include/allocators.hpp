@@ -0,0 +1,3745 @@
+/*
+ * Custom allocators used by allocators_practice.cpp
+ *
+ * Kept in a header so the exercises, benchmarks and any other target can share the
+ * same implementations.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#endif
+
+#include "debug_guards.hpp"
+#include "numa_topology.hpp"
+#include "page_provider.hpp"
+
+// =============================================================================
+// Exercise 1: ⭐ Basic Pool Allocator
+// =============================================================================
+
+/*
+ * GOAL: Implement a pool allocator for fixed-size allocations
+ *
+ * Pool allocators are ideal for:
+ * - Frequent allocations/deallocations of same-sized objects
+ * - Game entities, particles, audio samples
+ * - Linked lists, trees, graphs
+ *
+ * Performance target: 5-10x faster than default allocator
+ */
+
+// What trim()/shrink_to() do with a chunk that has no live blocks
+enum class PoolTrimMode {
+    release,   // Hand it back to the page provider
+    decommit,  // Keep the address range, drop its pages (release_pages); refilled on growth
+};
+
+// Shared by the pools' trim(): counts free blocks per chunk by walking the free list (so
+// allocate/deallocate pay nothing for occupancy tracking), unlinks up to max_chunks chunks
+// whose blocks are all free from the chunk list, and drops their blocks from the free list.
+template <typename Chunk, typename Block, typename ChunkOf>
+std::vector<Chunk*> unlink_empty_chunks(Chunk*& chunks, Block*& free_list,
+                                        size_t blocks_per_chunk, size_t max_chunks,
+                                        ChunkOf chunk_of) {
+    std::vector<Chunk*> empty;
+    if (max_chunks == 0) {
+        return empty;
+    }
+
+    std::unordered_map<const Chunk*, size_t> free_blocks;
+    for (const Block* block = free_list; block; block = block->next) {
+        free_blocks[chunk_of(block)]++;
+    }
+
+    for (Chunk** link = &chunks; *link && empty.size() < max_chunks;) {
+        auto it = free_blocks.find(*link);
+        if (it != free_blocks.end() && it->second == blocks_per_chunk) {
+            it->second = 0;  // Marks the chunk as taken for the pass below
+            empty.push_back(*link);
+            *link = (*link)->next;
+        } else {
+            link = &(*link)->next;
+        }
+    }
+
+    if (!empty.empty()) {
+        for (Block** link = &free_list; *link;) {
+            if (free_blocks[chunk_of(*link)] == 0) {
+                *link = (*link)->next;
+            } else {
+                link = &(*link)->next;
+            }
+        }
+    }
+    return empty;
+}
+
+enum class PoolGuardMode {
+    fast,
+    checked,  // Red zones, poison-on-free, double-free detection (debug_guards.hpp)
+};
+
+inline constexpr PoolGuardMode default_pool_guard_mode =
+    AllocatorGuards::enabled_by_default ? PoolGuardMode::checked : PoolGuardMode::fast;
+
+// Untyped free-list pool: the Block/Pool machinery behind PoolAllocator with the block size
+// as a runtime value, so anything of (at most) that size can share it. Not thread-safe.
+class FixedBlockPool {
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // Checked mode block: [GuardHeader][payload][red zone]. The header's next doubles as
+    // the FreeBlock link, so the free list and trim() work unchanged.
+    struct GuardHeader {
+        FreeBlock* next;
+        uint64_t state;
+    };
+    static constexpr uint64_t live_block = 0x11FE11FE11FE11FE;
+    static constexpr uint64_t free_block = 0xF4EEF4EEF4EEF4EE;
+
+    // Header of each chunk; blocks_per_pool_ blocks follow at header_size_
+    struct Pool {
+        Pool* next;
+    };
+
+    FreeBlock* free_list_ = nullptr;
+    Pool* current_pool_ = nullptr;
+    Pool* decommitted_ = nullptr;  // Trimmed with PoolTrimMode::decommit, reused first
+    PageProvider* pages_;
+    size_t block_size_;
+    size_t block_align_;
+    size_t blocks_per_pool_;
+    size_t header_size_;
+    size_t chunk_bytes_;
+    size_t pool_count_ = 0;  // Committed chunks (not counting decommitted_)
+    size_t total_allocated_ = 0;
+    size_t total_deallocated_ = 0;
+    bool checked_;
+    size_t front_ = 0;     // Checked mode: GuardHeader bytes before the payload
+    size_t payload_ = 0;   // Checked mode: bytes handed out
+    size_t red_zone_ = 0;  // Checked mode: canary bytes after the payload
+
+public:
+    // Chunks come from `pages`. They are a power of two of at least pool_bytes and the
+    // provider's granularity, aligned to their size so trim() finds a block's chunk by
+    // masking its address.
+    FixedBlockPool(size_t block_size, size_t block_align, size_t pool_bytes,
+                   PageProvider& pages = PageProvider::heap(),
+                   PoolGuardMode guards = default_pool_guard_mode)
+        : pages_(&pages),
+          block_align_(std::max(block_align, alignof(FreeBlock))),
+          checked_(guards == PoolGuardMode::checked) {
+        block_size_ = std::max(block_size, sizeof(FreeBlock));
+        block_size_ = (block_size_ + block_align_ - 1) / block_align_ * block_align_;
+        if (checked_) {
+            // The red zone starts right after the requested bytes and absorbs the padding
+            front_ = PageProvider::round_up(sizeof(GuardHeader), block_align_);
+            payload_ = block_size;
+            red_zone_ = PageProvider::round_up(payload_ + AllocatorGuards::red_zone,
+                                               block_align_) - payload_;
+            block_size_ = front_ + payload_ + red_zone_;
+        }
+        header_size_ = (sizeof(Pool) + block_align_ - 1) / block_align_ * block_align_;
+        chunk_bytes_ = std::bit_ceil(
+            std::max({pool_bytes, header_size_ + block_size_, pages.granularity()}));
+        blocks_per_pool_ = (chunk_bytes_ - header_size_) / block_size_;
+    }
+
+    ~FixedBlockPool() {
+        for (Pool* list : {current_pool_, decommitted_}) {
+            while (list) {
+                Pool* next = list->next;
+                AllocatorGuards::unpoison(list, chunk_bytes_);
+                pages_->deallocate_pages(list, chunk_bytes_, chunk_bytes_);
+                list = next;
+            }
+        }
+    }
+
+    FixedBlockPool(const FixedBlockPool&) = delete;
+    FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+    void* allocate() {
+        if (!free_list_) {
+            expand_pool();
+        }
+
+        FreeBlock* block = free_list_;
+        free_list_ = block->next;
+        total_allocated_++;
+        if (checked_) [[unlikely]] {
+            return checked_allocate(block);
+        }
+        return block;
+    }
+
+    void deallocate(void* ptr) {
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        if (checked_) [[unlikely]] {
+            block = checked_deallocate(ptr);
+            if (!block) {
+                return;  // Reported and skipped
+            }
+        }
+        block->next = free_list_;
+        free_list_ = block;
+        total_deallocated_++;
+    }
+
+    // Batch versions: one stats update per call, and deallocate_n splices the whole span
+    // onto the free list as a single chain. Checked mode checks block by block.
+    // If growing the pool throws, allocate_n hands nothing out: blocks already taken go back.
+    template <typename Ptr>
+    void allocate_n(std::span<Ptr> out) {
+        size_t filled = 0;
+        if (checked_) {
+            try {
+                for (; filled < out.size(); filled++) {
+                    out[filled] = static_cast<Ptr>(allocate());
+                }
+            } catch (...) {
+                deallocate_n(std::span<Ptr const>(out.first(filled)));
+                throw;
+            }
+            return;
+        }
+        try {
+            for (; filled < out.size(); filled++) {
+                if (!free_list_) {
+                    expand_pool();
+                }
+                FreeBlock* block = free_list_;
+                free_list_ = block->next;
+                out[filled] = static_cast<Ptr>(static_cast<void*>(block));
+            }
+        } catch (...) {
+            splice(std::span<Ptr const>(out.first(filled)));
+            throw;
+        }
+        total_allocated_ += out.size();
+    }
+
+    template <typename Ptr>
+    void deallocate_n(std::span<Ptr const> blocks) {
+        if (checked_) {
+            for (Ptr block : blocks) {
+                deallocate(static_cast<void*>(block));
+            }
+            return;
+        }
+        splice(blocks);
+        total_deallocated_ += blocks.size();
+    }
+
+    // Usable bytes per block (without checked mode's header and red zone)
+    size_t block_size() const {
+        return checked_ ? payload_ : block_size_;
+    }
+
+    bool checked() const {
+        return checked_;
+    }
+
+    size_t pool_count() const {
+        return pool_count_;
+    }
+
+    size_t allocated_count() const {
+        return total_allocated_;
+    }
+
+    size_t deallocated_count() const {
+        return total_deallocated_;
+    }
+
+    size_t current_usage() const {
+        return total_allocated_ - total_deallocated_;
+    }
+
+    // Committed chunk memory, free blocks included
+    size_t reserved_bytes() const {
+        return pool_count_ * chunk_bytes_;
+    }
+
+    // Give back chunks with no live blocks until at most `bytes` stay reserved.
+    // Returns the bytes given back.
+    size_t shrink_to(size_t bytes, PoolTrimMode mode = PoolTrimMode::release) {
+        size_t excess = reserved_bytes() > bytes ? reserved_bytes() - bytes : 0;
+        size_t max_chunks = (excess + chunk_bytes_ - 1) / chunk_bytes_;
+
+        std::vector<Pool*> empty = unlink_empty_chunks(
+            current_pool_, free_list_, blocks_per_pool_, max_chunks,
+            [this](const FreeBlock* block) { return chunk_of(block); });
+
+        for (Pool* pool : empty) {
+            AllocatorGuards::unpoison(pool, chunk_bytes_);
+            if (mode == PoolTrimMode::decommit) {
+                // The header stays in the first page, which release_pages() keeps
+                pages_->release_pages(reinterpret_cast<char*>(pool) + header_size_,
+                                      chunk_bytes_ - header_size_);
+                pool->next = decommitted_;
+                decommitted_ = pool;
+            } else {
+                pages_->deallocate_pages(pool, chunk_bytes_, chunk_bytes_);
+            }
+        }
+        pool_count_ -= empty.size();
+        return empty.size() * chunk_bytes_;
+    }
+
+    size_t trim(PoolTrimMode mode = PoolTrimMode::release) {
+        return shrink_to(0, mode);
+    }
+
+private:
+    // A free block's payload must still hold the poison pattern; anything else was written
+    // through a dangling pointer
+    void* checked_allocate(FreeBlock* block) {
+        auto* header = reinterpret_cast<GuardHeader*>(block);
+        char* payload = reinterpret_cast<char*>(block) + front_;
+        AllocatorGuards::unpoison(payload, payload_);
+        if (header->state != free_block ||
+            !AllocatorGuards::intact(payload, payload_, AllocatorGuards::freed)) {
+            AllocatorGuards::report("pool block written after free", payload);
+        }
+        header->state = live_block;
+        return payload;
+    }
+
+    // Returns the block to push on the free list, or nullptr if the free must be skipped
+    FreeBlock* checked_deallocate(void* ptr) {
+        char* payload = static_cast<char*>(ptr);
+        auto* header = reinterpret_cast<GuardHeader*>(payload - front_);
+        if (header->state == free_block) {
+            AllocatorGuards::report("double free of a pool block", ptr);
+            return nullptr;
+        }
+        if (header->state != live_block) {
+            AllocatorGuards::report("pool block header overwritten (underflow or foreign pointer)",
+                                    ptr);
+            return nullptr;
+        }
+
+        char* red_zone = payload + payload_;
+        AllocatorGuards::unpoison(red_zone, red_zone_);
+        if (!AllocatorGuards::intact(red_zone, red_zone_, AllocatorGuards::canary)) {
+            AllocatorGuards::report("pool block red zone overwritten (buffer overflow)", ptr);
+            std::memset(red_zone, AllocatorGuards::canary, red_zone_);
+        }
+
+        std::memset(payload, AllocatorGuards::freed, payload_);
+        AllocatorGuards::poison(payload, payload_ + red_zone_);
+        header->state = free_block;
+        return reinterpret_cast<FreeBlock*>(header);
+    }
+
+    // Free blocks: poisoned payload, canary red zone (poisoned whether live or free)
+    void guard_chunk(char* blocks) {
+        for (size_t i = 0; i < blocks_per_pool_; i++) {
+            char* block = blocks + i * block_size_;
+            reinterpret_cast<GuardHeader*>(block)->state = free_block;
+            std::memset(block + front_, AllocatorGuards::freed, payload_);
+            std::memset(block + front_ + payload_, AllocatorGuards::canary, red_zone_);
+            AllocatorGuards::poison(block + front_, payload_ + red_zone_);
+        }
+    }
+
+    const Pool* chunk_of(const FreeBlock* block) const {
+        return reinterpret_cast<const Pool*>(reinterpret_cast<uintptr_t>(block) &
+                                             ~(uintptr_t{chunk_bytes_} - 1));
+    }
+
+    // Link blocks into one chain in front of the free list (no stats, no checks)
+    template <typename Ptr>
+    void splice(std::span<Ptr const> blocks) {
+        if (blocks.empty()) {
+            return;
+        }
+        for (size_t i = 0; i + 1 < blocks.size(); i++) {
+            static_cast<FreeBlock*>(static_cast<void*>(blocks[i]))->next =
+                static_cast<FreeBlock*>(static_cast<void*>(blocks[i + 1]));
+        }
+        static_cast<FreeBlock*>(static_cast<void*>(blocks.back()))->next = free_list_;
+        free_list_ = static_cast<FreeBlock*>(static_cast<void*>(blocks.front()));
+    }
+
+    void expand_pool() {
+        void* raw = nullptr;
+        if (decommitted_) {
+            raw = decommitted_;
+            decommitted_ = decommitted_->next;
+        } else {
+            raw = pages_->allocate_pages(chunk_bytes_, chunk_bytes_);
+        }
+        Pool* new_pool = static_cast<Pool*>(raw);
+        new_pool->next = current_pool_;
+        current_pool_ = new_pool;
+        pool_count_++;
+
+        char* blocks = static_cast<char*>(raw) + header_size_;
+        for (size_t i = 0; i < blocks_per_pool_; i++) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(blocks + i * block_size_);
+            block->next = (i + 1 < blocks_per_pool_)
+                              ? reinterpret_cast<FreeBlock*>(blocks + (i + 1) * block_size_)
+                              : free_list_;
+        }
+        free_list_ = reinterpret_cast<FreeBlock*>(blocks);
+
+        if (checked_) {
+            guard_chunk(blocks);
+        }
+    }
+};
+
+// Upstream memory resource shared by a PoolAllocator and everything rebound or copied from it.
+// Holds one FixedBlockPool per distinct block layout, so std::list<T>'s node allocator and
+// the user's PoolAllocator<T> draw from (and report on) the same memory.
+class PoolResource {
+private:
+    struct Entry {
+        size_t size;
+        size_t align;
+        std::unique_ptr<FixedBlockPool> pool;
+    };
+
+    std::vector<Entry> pools_;
+    size_t pool_bytes_;
+    PageProvider* pages_;
+    PoolGuardMode guards_;
+
+public:
+    explicit PoolResource(size_t pool_bytes = 1024, PageProvider& pages = PageProvider::heap(),
+                          PoolGuardMode guards = default_pool_guard_mode)
+        : pool_bytes_(pool_bytes), pages_(&pages), guards_(guards) {}
+
+    ~PoolResource() {
+        // Print statistics
+        std::cout << "🏊 PoolAllocator destroyed\n";
+        std::cout << "   Allocated: " << allocated_count() << "\n";
+        std::cout << "   Deallocated: " << deallocated_count() << "\n";
+
+        // Check for leaks
+        if (current_usage() != 0) {
+            std::cout << "⚠️  Memory leak: " << current_usage() << " objects not freed!\n";
+        }
+    }
+
+    PoolResource(const PoolResource&) = delete;
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    // Created on first use; the returned pool lives as long as the resource
+    FixedBlockPool& pool_for(size_t size, size_t align) {
+        for (auto& entry : pools_) {
+            if (entry.size == size && entry.align == align) {
+                return *entry.pool;
+            }
+        }
+        pools_.push_back({size, align,
+                          std::make_unique<FixedBlockPool>(size, align, pool_bytes_, *pages_,
+                                                           guards_)});
+        return *pools_.back().pool;
+    }
+
+    size_t allocated_count() const {
+        return sum(&FixedBlockPool::allocated_count);
+    }
+
+    size_t deallocated_count() const {
+        return sum(&FixedBlockPool::deallocated_count);
+    }
+
+    size_t current_usage() const {
+        return sum(&FixedBlockPool::current_usage);
+    }
+
+    size_t pool_count() const {
+        return sum(&FixedBlockPool::pool_count);
+    }
+
+    size_t reserved_bytes() const {
+        return sum(&FixedBlockPool::reserved_bytes);
+    }
+
+    // Empty chunks of every block size count towards `bytes`; returns the bytes given back
+    size_t shrink_to(size_t bytes, PoolTrimMode mode = PoolTrimMode::release) {
+        size_t released = 0;
+        for (auto& entry : pools_) {
+            size_t others = reserved_bytes() - entry.pool->reserved_bytes();
+            released += entry.pool->shrink_to(bytes > others ? bytes - others : 0, mode);
+        }
+        return released;
+    }
+
+    size_t trim(PoolTrimMode mode = PoolTrimMode::release) {
+        return shrink_to(0, mode);
+    }
+
+    void print_stats() const {
+        for (const auto& entry : pools_) {
+            std::cout << "   " << entry.pool->block_size() << "B blocks: "
+                      << entry.pool->allocated_count() << " allocs, "
+                      << entry.pool->current_usage() << " live, " << entry.pool->pool_count()
+                      << " pools\n";
+        }
+    }
+
+private:
+    size_t sum(size_t (FixedBlockPool::*stat)() const) const {
+        size_t total = 0;
+        for (const auto& entry : pools_) {
+            total += ((*entry.pool).*stat)();
+        }
+        return total;
+    }
+};
+
+template <typename T, size_t PoolSize = 1024>
+class PoolAllocator {
+private:
+    // TODO: Define your data structures
+    // Hints:
+    // - Use a union for free list (stores either T or next pointer)
+    // - Keep track of free blocks
+    // - May need multiple pools if one fills up
+
+    union Block {
+        // TODO: Implement Block structure
+        // When free: stores pointer to next free block
+        // When allocated: stores actual T object
+        T element;
+        Block* next;
+    };
+
+    // TODO: Add member variables
+    std::shared_ptr<PoolResource> resource_;
+    // resource_'s pool for Block, cached to skip the lookup; rebound copies find it lazily
+    FixedBlockPool* blocks_ = nullptr;
+
+public:
+    using value_type = T;
+
+    // TODO: Implement constructor
+    PoolAllocator() : PoolAllocator(std::make_shared<PoolResource>(PoolSize)) {
+        std::cout << "🏊 PoolAllocator created for type: " << typeid(T).name() << "\n";
+    }
+
+    // Several containers can share one resource, so freed blocks are reused across them
+    explicit PoolAllocator(std::shared_ptr<PoolResource> resource)
+        : resource_(std::move(resource)),
+          blocks_(&resource_->pool_for(sizeof(Block), alignof(Block))) {}
+
+    // TODO: Implement destructor
+    ~PoolAllocator() = default;
+
+    // TODO: Implement copy constructor (for rebinding)
+    // Rebinding shares the upstream resource; only the block size differs. The pool for the
+    // new block size is found (or created) on first use, so rebinding itself can't throw.
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, PoolSize>& other) noexcept
+        : resource_(other.resource()) {}
+
+    // TODO: Implement allocate
+    T* allocate(size_t n) {
+        // Hints:
+        // 1. If n != 1, fall back to ::operator new (pools are for single objects)
+        // 2. If free_list_ is empty, create new pool (expand_pool())
+        // 3. Pop a block from free list
+        // 4. Update statistics
+        // 5. Return pointer to block (cast appropriately)
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        return static_cast<T*>(blocks().allocate());
+    }
+
+    // TODO: Implement deallocate
+    void deallocate(T* ptr, size_t n) {
+        // Hints:
+        // 1. If n != 1, use ::operator delete
+        // 2. Cast pointer to Block*
+        // 3. Push block back onto free list
+        // 4. Update statistics
+        // 5. Don't actually free memory (reuse it!)
+
+        if (n != 1) {
+            ::operator delete(ptr);
+            return;
+        }
+        blocks().deallocate(ptr);
+    }
+
+    // Fill `out` with single-object blocks / return them, e.g. a frame's worth of particles
+    void allocate_n(std::span<T*> out) {
+        blocks().allocate_n(out);
+    }
+
+    void deallocate_n(std::span<T* const> ptrs) {
+        blocks().deallocate_n(ptrs);
+    }
+
+    // TODO: Implement rebind for different types
+    template <typename U>
+    struct rebind {
+        using other = PoolAllocator<U, PoolSize>;
+    };
+
+    // TODO: Implement statistics methods
+    // These cover the whole shared resource, i.e. every type rebound from this allocator
+    size_t allocated_count() const {
+        return resource_->allocated_count();
+    }
+
+    size_t deallocated_count() const {
+        return resource_->deallocated_count();
+    }
+
+    size_t current_usage() const {
+        return resource_->current_usage();
+    }
+
+    // Give empty chunks back (see PoolResource::shrink_to)
+    size_t shrink_to(size_t bytes, PoolTrimMode mode = PoolTrimMode::release) {
+        return resource_->shrink_to(bytes, mode);
+    }
+
+    size_t trim(PoolTrimMode mode = PoolTrimMode::release) {
+        return resource_->trim(mode);
+    }
+
+    const std::shared_ptr<PoolResource>& resource() const {
+        return resource_;
+    }
+
+private:
+    // Blocks reaching deallocate() came from an equal allocator, which already created
+    // this pool, so only allocate() can end up creating it
+    FixedBlockPool& blocks() {
+        if (!blocks_) [[unlikely]] {
+            blocks_ = &resource_->pool_for(sizeof(Block), alignof(Block));
+        }
+        return *blocks_;
+    }
+};
+
+// TODO: Implement comparison operators (required for C++17+)
+// Equal iff memory from one can be returned through the other, i.e. same resource
+template <typename T, typename U, size_t PoolSize>
+bool operator==(const PoolAllocator<T, PoolSize>& a, const PoolAllocator<U, PoolSize>& b) noexcept {
+    return a.resource() == b.resource();
+}
+
+template <typename T, typename U, size_t PoolSize>
+bool operator!=(const PoolAllocator<T, PoolSize>& a, const PoolAllocator<U, PoolSize>& b) noexcept {
+    return a.resource() != b.resource();
+}
+
+// =============================================================================
+// Exercise 1b: 🌟 Small-Object Allocator (size classes)
+// =============================================================================
+
+/*
+ * GOAL: One allocator for many small types instead of one pool per T
+ *
+ * Requests up to max_size bytes are rounded up to a 16-byte size class, and each class is
+ * a FixedBlockPool. Every SmallObjectAllocator<T> rebound from the same instance shares the
+ * same SmallObjectPool, so std::map/std::list nodes, small vectors and strings of different
+ * types all draw from one set of pools. Larger or over-aligned requests go to the heap.
+ *
+ * Not thread-safe (same as PoolAllocator).
+ */
+
+class SmallObjectPool {
+public:
+    static constexpr size_t granularity = 16;
+    static constexpr size_t max_size = 256;
+    static constexpr size_t num_classes = max_size / granularity;
+
+private:
+    std::unique_ptr<FixedBlockPool> classes_[num_classes];
+    size_t pooled_allocations_ = 0;
+    size_t fallback_allocations_ = 0;
+
+public:
+    explicit SmallObjectPool(size_t pool_bytes = 16 * 1024) {
+        for (size_t i = 0; i < num_classes; ++i) {
+            classes_[i] = std::make_unique<FixedBlockPool>((i + 1) * granularity, granularity,
+                                                           pool_bytes);
+        }
+    }
+
+    SmallObjectPool(const SmallObjectPool&) = delete;
+    SmallObjectPool& operator=(const SmallObjectPool&) = delete;
+
+    static bool is_small(size_t bytes, size_t alignment) {
+        return bytes <= max_size && alignment <= granularity;
+    }
+
+    void* allocate(size_t bytes, size_t alignment) {
+        if (!is_small(bytes, alignment)) {
+            fallback_allocations_++;
+            return ::operator new(bytes, std::align_val_t{alignment});
+        }
+        pooled_allocations_++;
+        return classes_[class_index(bytes)]->allocate();
+    }
+
+    void deallocate(void* ptr, size_t bytes, size_t alignment) {
+        if (!is_small(bytes, alignment)) {
+            ::operator delete(ptr, std::align_val_t{alignment});
+            return;
+        }
+        classes_[class_index(bytes)]->deallocate(ptr);
+    }
+
+    size_t pooled_allocations() const {
+        return pooled_allocations_;
+    }
+
+    size_t fallback_allocations() const {
+        return fallback_allocations_;
+    }
+
+    const FixedBlockPool& size_class(size_t index) const {
+        return *classes_[index];
+    }
+
+    void print_stats() const {
+        std::cout << "📐 SmallObjectPool: " << pooled_allocations_ << " pooled, "
+                  << fallback_allocations_ << " heap fallbacks\n";
+        for (size_t i = 0; i < num_classes; ++i) {
+            const FixedBlockPool& pool = *classes_[i];
+            if (pool.allocated_count() == 0) {
+                continue;
+            }
+            std::cout << "   " << pool.block_size() << "B: " << pool.allocated_count()
+                      << " allocs, " << pool.current_usage() << " live, " << pool.pool_count()
+                      << " pools\n";
+        }
+    }
+
+private:
+    static size_t class_index(size_t bytes) {
+        return bytes == 0 ? 0 : (bytes - 1) / granularity;
+    }
+};
+
+template <typename T>
+class SmallObjectAllocator {
+private:
+    std::shared_ptr<SmallObjectPool> pool_;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    SmallObjectAllocator() : pool_(std::make_shared<SmallObjectPool>()) {}
+
+    explicit SmallObjectAllocator(std::shared_ptr<SmallObjectPool> pool)
+        : pool_(std::move(pool)) {}
+
+    // Rebinding shares the backing store
+    template <typename U>
+    SmallObjectAllocator(const SmallObjectAllocator<U>& other) noexcept
+        : pool_(other.get_pool()) {}
+
+    T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(pool_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        pool_->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    template <typename U>
+    struct rebind {
+        using other = SmallObjectAllocator<U>;
+    };
+
+    const std::shared_ptr<SmallObjectPool>& get_pool() const {
+        return pool_;
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const SmallObjectAllocator<T>& a, const SmallObjectAllocator<U>& b) noexcept {
+    return a.get_pool() == b.get_pool();
+}
+
+template <typename T, typename U>
+bool operator!=(const SmallObjectAllocator<T>& a, const SmallObjectAllocator<U>& b) noexcept {
+    return a.get_pool() != b.get_pool();
+}
+
+// =============================================================================
+// Exercise 2: ⭐⭐ Arena (Stack) Allocator
+// =============================================================================
+
+/*
+ * GOAL: Implement an arena allocator for batch allocations
+ *
+ * Arena allocators are ideal for:
+ * - Per-frame allocations in games
+ * - Request-scoped allocations in servers
+ * - Parsing/compilation temporary data
+ *
+ * Key feature: Deallocate everything at once (reset)
+ */
+
+// What reset() does with the blocks a growable arena has chained on
+enum class ArenaResetPolicy {
+    keep_largest,  // Free everything except the largest block (bounded RSS)
+    retain_all,    // Keep every block for reuse by the next cycle (no re-growth)
+};
+
+struct ArenaGrowthPolicy {
+    size_t growth_factor = 2;   // Each new block is growth_factor x the previous one
+    size_t max_block_size = 0;  // Cap on the geometric size (0 = uncapped)
+    ArenaResetPolicy reset_policy = ArenaResetPolicy::keep_largest;
+    bool trim_on_reset = false;  // Call trim() at the end of every reset()
+};
+
+// Compile-time diagnostics switch for BasicArena. The silent policy compiles every trace
+// statement out, so Arena::allocate is a pointer bump plus one bounds check.
+// checked adds a red zone after every allocation, poison-on-free and a poisoned tail
+// (debug_guards.hpp); it follows IMPSTUDY_ALLOCATOR_GUARDS unless a policy forces it.
+struct SilentArenaPolicy {
+    static constexpr bool trace = false;
+    static constexpr bool checked = AllocatorGuards::enabled_by_default;
+};
+
+struct TracingArenaPolicy {
+    static constexpr bool trace = true;
+    static constexpr bool checked = AllocatorGuards::enabled_by_default;
+};
+
+struct CheckedArenaPolicy {
+    static constexpr bool trace = false;
+    static constexpr bool checked = true;
+};
+
+template <typename Policy = SilentArenaPolicy>
+class BasicArena {
+private:
+    // Every block starts with this header; its usable bytes follow
+    struct Chunk {
+        Chunk* next;
+        size_t size;
+    };
+    static constexpr size_t chunk_alignment = alignof(std::max_align_t);
+
+    // Checked mode: guards_ lists the live allocations so whatever deallocate/rewind/reset
+    // drops can be verified and poisoned.
+    struct Guard {
+        char* ptr;
+        size_t size;
+    };
+    struct NoGuards {};
+
+    // TODO: Add member variables
+    char* buffer_;       // Pointer to memory block
+    size_t size_;        // Total size
+    size_t offset_;      // Current allocation offset
+    size_t peak_usage_;  // Peak memory usage (statistics)
+
+    // Chaining: current_ is the block buffer_ points into, older blocks follow it.
+    // spare_ holds blocks kept by ArenaResetPolicy::retain_all that are not in use yet.
+    Chunk* current_ = nullptr;
+    Chunk* spare_ = nullptr;
+    size_t retired_used_ = 0;  // Bytes used in blocks behind current_
+    size_t total_size_ = 0;    // Sum of all owned blocks (in use and spare)
+    size_t peak_total_size_ = 0;
+    uint64_t epoch_ = 0;  // Bumped by reset() and rewind()
+    bool growable_ = false;
+    ArenaGrowthPolicy growth_;
+    PageProvider* pages_;  // Where blocks come from; not owned
+    [[no_unique_address]] std::conditional_t<Policy::checked, std::vector<Guard>, NoGuards>
+        guards_;
+
+public:
+    // Checked mode: every allocation is followed by guard_bytes of canaries (counted in used())
+    static constexpr size_t guard_bytes = Policy::checked ? AllocatorGuards::red_zone : 0;
+
+    // TODO: Implement constructor
+    // Fixed-size arena: throws std::bad_alloc once size bytes are used. Block sizes are
+    // rounded up to the page provider's granularity.
+    explicit BasicArena(size_t size, PageProvider& pages = PageProvider::heap())
+        : size_(size), offset_(0), peak_usage_(0), pages_(&pages) {
+        // Hints:
+        // - Allocate buffer_ with new char[size]
+        // - Initialize offset_ to 0
+        // - Print creation message
+        use_chunk(new_chunk(size));
+        std::cout << "🏟️ Arena created (" << size << " bytes)\n";
+    }
+
+    // Growable arena: chains a new, geometrically larger block whenever the current one fills
+    BasicArena(size_t initial_size, ArenaGrowthPolicy growth,
+               PageProvider& pages = PageProvider::heap())
+        : BasicArena(initial_size, pages) {
+        growable_ = true;
+        growth_ = growth;
+        growth_.growth_factor = std::max<size_t>(growth_.growth_factor, 1);
+    }
+
+    // TODO: Implement destructor
+    ~BasicArena() {
+        // Hints:
+        // - Delete buffer_
+        // - Print destruction message with statistics
+        if (!current_ && !spare_) {
+            return;  // Moved-from
+        }
+
+        std::cout << "🏟️ Arena destroyed\n";
+        std::cout << "   Total size: " << total_size_ << " bytes\n";
+        std::cout << "   Peak usage: " << peak_usage() << " bytes\n";
+        std::cout << "   Utilization: " << (100.0 * peak_usage() / peak_total_size_) << "%\n";
+
+        release_all();
+    }
+
+    // Arena should not be copyable (it owns memory)
+    BasicArena(const BasicArena&) = delete;
+    BasicArena& operator=(const BasicArena&) = delete;
+
+    // TODO: Implement move constructor and assignment if desired
+    BasicArena(BasicArena&& other) noexcept
+        : buffer_(other.buffer_),
+          size_(other.size_),
+          offset_(other.offset_),
+          peak_usage_(other.peak_usage_),
+          current_(other.current_),
+          spare_(other.spare_),
+          retired_used_(other.retired_used_),
+          total_size_(other.total_size_),
+          peak_total_size_(other.peak_total_size_),
+          epoch_(other.epoch_),
+          growable_(other.growable_),
+          growth_(other.growth_),
+          pages_(other.pages_),
+          guards_(std::move(other.guards_)) {
+        other.buffer_ = nullptr;
+        other.current_ = nullptr;
+        other.spare_ = nullptr;
+    }
+
+    BasicArena& operator=(BasicArena&& other) noexcept {
+        if (this != &other) {
+            release_all();
+
+            buffer_ = other.buffer_;
+            size_ = other.size_;
+            offset_ = other.offset_;
+            peak_usage_ = other.peak_usage_;
+            current_ = other.current_;
+            spare_ = other.spare_;
+            retired_used_ = other.retired_used_;
+            total_size_ = other.total_size_;
+            peak_total_size_ = other.peak_total_size_;
+            epoch_ = other.epoch_;
+            growable_ = other.growable_;
+            growth_ = other.growth_;
+            pages_ = other.pages_;
+            guards_ = std::move(other.guards_);
+
+            other.buffer_ = nullptr;
+            other.current_ = nullptr;
+            other.spare_ = nullptr;
+        }
+        return *this;
+    }
+
+    // TODO: Implement allocate with alignment
+    // Fast path: round the bump pointer up to `alignment` (a power of two) and bump it.
+    // Growth, failure and tracing live out of line.
+    void* allocate(size_t n, size_t alignment = alignof(std::max_align_t)) {
+        // Hints:
+        // 1. Calculate aligned offset using std::align
+        // 2. Check if enough space available
+        // 3. Update offset_
+        // 4. Update peak_usage_
+        // 5. Return pointer to allocated memory
+        // 6. Throw std::bad_alloc if not enough space
+        assert(std::has_single_bit(alignment));
+
+        uintptr_t base = reinterpret_cast<uintptr_t>(buffer_);
+        uintptr_t aligned = (base + offset_ + alignment - 1) & ~(uintptr_t{alignment} - 1);
+        size_t start = aligned - base;
+
+        if (start > size_ || n > size_ - start || size_ - start - n < guard_bytes) [[unlikely]] {
+            return allocate_slow(n, alignment);
+        }
+
+        // peak_usage_ is folded in lazily (reset/grow/peak_usage()) to keep this path flat
+        offset_ = start + n + guard_bytes;
+        if constexpr (Policy::trace) {
+            trace_allocation(n, alignment);
+        }
+        if constexpr (Policy::checked) {
+            open_guard(reinterpret_cast<char*>(aligned), n);
+        }
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Only the most recent allocation can be given back (its end is the bump pointer);
+    // anything else stays dead until rewind()/reset(). Returns whether bytes were reclaimed.
+    // The caller must know ptr was allocated since the last reset()/rewind(): a stale
+    // pointer can match a newer allocation at the same address.
+    bool deallocate(void* ptr, size_t n) noexcept {
+        if (!is_top(ptr, n)) {
+            return false;
+        }
+        peak_usage_ = peak_usage();
+        offset_ = static_cast<char*>(ptr) - buffer_;
+        if constexpr (Policy::checked) {
+            close_guards(guards_.empty() ? 0 : guards_.size() - 1);
+        }
+        if constexpr (Policy::trace) {
+            std::cout << "  ♻️ Arena reclaimed " << n << " bytes at the top\n";
+        }
+        return true;
+    }
+
+    // For callers that may outlive a reset()/rewind() (allocator adapters): pass the epoch()
+    // ptr was allocated in, and memory from an older epoch is never reclaimed
+    bool deallocate(void* ptr, size_t n, uint64_t epoch) noexcept {
+        return epoch == epoch_ && deallocate(ptr, n);
+    }
+
+    // realloc-style resize of the most recent allocation without moving it. Fails (returns
+    // false, nothing changed) if ptr is not the top allocation or the block has no room.
+    bool try_extend(void* ptr, size_t old_size, size_t new_size) noexcept {
+        if (!is_top(ptr, old_size)) {
+            return false;
+        }
+        size_t start = static_cast<char*>(ptr) - buffer_;
+        if (new_size > size_ - start - guard_bytes) {
+            return false;
+        }
+        peak_usage_ = peak_usage();
+        offset_ = start + new_size + guard_bytes;
+        if constexpr (Policy::checked) {
+            // Same allocation, new size: keep the contents, move the red zone
+            Guard top = guards_.back();
+            guards_.pop_back();
+            check_guard(top);
+            if (new_size < old_size) {
+                std::memset(top.ptr + new_size, AllocatorGuards::freed, old_size - new_size);
+            }
+            AllocatorGuards::poison(top.ptr, old_size + guard_bytes);
+            open_guard(top.ptr, new_size);
+        }
+        if constexpr (Policy::trace) {
+            std::cout << "  ↔️ Arena resized top allocation " << old_size << " -> " << new_size
+                      << " bytes in place\n";
+        }
+        return true;
+    }
+
+    // TODO: Implement reset (deallocate all at once)
+    void reset() {
+        // Hints:
+        // - Set offset_ back to 0
+        // - Print reset message with how much was used
+        if constexpr (Policy::trace) {
+            std::cout << "  🔄 Arena reset (was using " << used() << " bytes)\n";
+        }
+        peak_usage_ = peak_usage();
+        if constexpr (Policy::checked) {
+            close_guards(0);
+        }
+
+        if (current_->next || spare_) {
+            // Pick the largest block to restart from; the rest follow the reset policy
+            Chunk* all = current_;
+            Chunk* tail = current_;
+            while (tail->next) {
+                tail = tail->next;
+            }
+            tail->next = spare_;
+            spare_ = nullptr;
+
+            Chunk* largest = all;
+            for (Chunk* c = all; c; c = c->next) {
+                if (c->size > largest->size) {
+                    largest = c;
+                }
+            }
+
+            for (Chunk* c = all; c;) {
+                Chunk* next = c->next;
+                if (c != largest) {
+                    if (growth_.reset_policy == ArenaResetPolicy::retain_all) {
+                        c->next = spare_;
+                        spare_ = c;
+                    } else {
+                        total_size_ -= c->size;
+                        free_chunk(c);
+                    }
+                }
+                c = next;
+            }
+
+            largest->next = nullptr;
+            use_chunk(largest);
+        }
+
+        offset_ = 0;
+        retired_used_ = 0;
+        epoch_++;
+
+        if (growth_.trim_on_reset) {
+            trim();
+        }
+    }
+
+    // Hand the memory of spare blocks and of the current block past the bump pointer back
+    // to the OS, if the page provider can (MmapPageProvider: MADV_DONTNEED). The blocks stay
+    // owned and usable; touching them again faults in fresh zero pages.
+    void trim() noexcept {
+        for (Chunk* c = spare_; c; c = c->next) {
+            pages_->release_pages(c + 1, c->size);
+        }
+        pages_->release_pages(buffer_ + offset_, size_ - offset_);
+    }
+
+    // Position in the arena that rewind() can return to. Invalidated by reset() and by
+    // rewinding past it.
+    struct Marker {
+        Chunk* chunk;
+        size_t offset;
+        size_t retired_used;
+        size_t guard_count;  // Checked mode: live allocations at the mark
+    };
+
+    Marker mark() const {
+        if constexpr (Policy::checked) {
+            return {current_, offset_, retired_used_, guards_.size()};
+        } else {
+            return {current_, offset_, retired_used_, 0};
+        }
+    }
+
+    // Free everything allocated after `marker`; earlier allocations stay valid.
+    // Blocks chained on since the marker are kept as spares for the next growth.
+    void rewind(const Marker& marker) {
+        if constexpr (Policy::trace) {
+            std::cout << "  ⏪ Arena rewind (" << used() << " -> "
+                      << marker.retired_used + marker.offset << " bytes)\n";
+        }
+        peak_usage_ = peak_usage();
+        if constexpr (Policy::checked) {
+            close_guards(marker.guard_count);
+        }
+
+        while (current_ != marker.chunk) {
+            assert(current_ && "marker does not belong to this arena");
+            Chunk* chunk = current_;
+            current_ = chunk->next;
+            chunk->next = spare_;
+            spare_ = chunk;
+        }
+
+        use_chunk(current_);
+        offset_ = marker.offset;
+        retired_used_ = marker.retired_used;
+        epoch_++;
+    }
+
+    // TODO: Implement statistics methods
+    // Bytes handed out since the last reset, across all chained blocks
+    size_t used() const {
+        return retired_used_ + offset_;
+    }
+
+    // Bytes left in the current block
+    size_t available() const {
+        return size_ - offset_;
+    }
+
+    size_t peak_usage() const {
+        return std::max(peak_usage_, used());
+    }
+
+    // Changes on every reset() and rewind(), after which addresses handed out before may be
+    // handed out again
+    uint64_t epoch() const {
+        return epoch_;
+    }
+
+    // Bytes owned by the arena across all blocks
+    size_t total_size() const {
+        return total_size_;
+    }
+
+    size_t block_count() const {
+        size_t count = 0;
+        for (Chunk* c = current_; c; c = c->next) {
+            count++;
+        }
+        for (Chunk* c = spare_; c; c = c->next) {
+            count++;
+        }
+        return count;
+    }
+
+private:
+    bool is_top(void* ptr, size_t n) const {
+        char* p = static_cast<char*>(ptr);
+        char* top = buffer_ + offset_;
+        return p >= buffer_ && p <= top && static_cast<size_t>(top - p) == n + guard_bytes;
+    }
+
+    // Checked mode: hand out [ptr, ptr + n) and arm the red zone behind it
+    void open_guard(char* ptr, size_t n) {
+        AllocatorGuards::unpoison(ptr, n + guard_bytes);
+        std::memset(ptr + n, AllocatorGuards::canary, guard_bytes);
+        AllocatorGuards::poison(ptr + n, guard_bytes);
+        guards_.push_back({ptr, n});
+    }
+
+    // Checked mode: verify the red zones of every allocation from index `first` on, then
+    // fill them with the freed pattern and poison them
+    void close_guards(size_t first) {
+        for (size_t i = first; i < guards_.size(); i++) {
+            auto [ptr, n] = guards_[i];
+            check_guard(guards_[i]);
+            AllocatorGuards::unpoison(ptr, n);
+            std::memset(ptr, AllocatorGuards::freed, n);
+            AllocatorGuards::poison(ptr, n + guard_bytes);
+        }
+        guards_.resize(first);
+    }
+
+    // Leaves the red zone unpoisoned
+    void check_guard(const Guard& guard) {
+        char* red_zone = guard.ptr + guard.size;
+        AllocatorGuards::unpoison(red_zone, guard_bytes);
+        if (!AllocatorGuards::intact(red_zone, guard_bytes, AllocatorGuards::canary)) {
+            AllocatorGuards::report("arena red zone overwritten (buffer overflow)", guard.ptr);
+        }
+    }
+
+    [[gnu::noinline]] void* allocate_slow(size_t n, size_t alignment) {
+        if (!growable_) {
+            // Step 6: Not enough space
+            std::cout << "  ❌ Arena allocation failed!\n"
+                      << "     Requested: " << n << " bytes\n"
+                      << "     Alignment: " << alignment << " bytes\n"
+                      << "     Available: " << available() << " bytes\n";
+            throw std::bad_alloc();
+        }
+
+        grow(n + alignment + guard_bytes);
+        return allocate(n, alignment);  // Fresh block is big enough by construction
+    }
+
+    [[gnu::noinline]] void trace_allocation(size_t n, size_t alignment) const {
+        std::cout << "  📦 Arena allocated " << n << " bytes "
+                  << "(alignment: " << alignment << ", "
+                  << "offset: " << offset_ << ", "
+                  << "available: " << available() << ")\n";
+    }
+
+    Chunk* new_chunk(size_t size) {
+        size_t bytes = PageProvider::round_up(sizeof(Chunk) + size, pages_->granularity());
+        Chunk* chunk = static_cast<Chunk*>(pages_->allocate_pages(bytes, chunk_alignment));
+        chunk->next = nullptr;
+        chunk->size = bytes - sizeof(Chunk);
+        if constexpr (Policy::checked) {
+            AllocatorGuards::poison(chunk + 1, chunk->size);  // Nothing handed out yet
+        }
+        total_size_ += chunk->size;
+        peak_total_size_ = std::max(peak_total_size_, total_size_);
+        return chunk;
+    }
+
+    void use_chunk(Chunk* chunk) {
+        current_ = chunk;
+        buffer_ = reinterpret_cast<char*>(chunk + 1);
+        size_ = chunk->size;
+        offset_ = 0;
+    }
+
+    // Retire the current block and continue in one that fits at least `needed` bytes
+    void grow(size_t needed) {
+        Chunk* chunk = nullptr;
+        for (Chunk** link = &spare_; *link; link = &(*link)->next) {
+            if ((*link)->size >= needed) {
+                chunk = *link;
+                *link = chunk->next;
+                break;
+            }
+        }
+
+        if (!chunk) {
+            size_t next_size = size_ * growth_.growth_factor;
+            if (growth_.max_block_size != 0) {
+                next_size = std::min(next_size, growth_.max_block_size);
+            }
+            // An oversized request still succeeds; it just gets a block of its own
+            chunk = new_chunk(std::max(next_size, needed));
+            if constexpr (Policy::trace) {
+                std::cout << "  📈 Arena grew by " << chunk->size << " bytes\n";
+            }
+        }
+
+        peak_usage_ = peak_usage();
+        retired_used_ += offset_;
+        chunk->next = current_;
+        use_chunk(chunk);
+    }
+
+    void free_chunk(Chunk* chunk) noexcept {
+        AllocatorGuards::unpoison(chunk + 1, chunk->size);
+        pages_->deallocate_pages(chunk, sizeof(Chunk) + chunk->size, chunk_alignment);
+    }
+
+    void release_all() {
+        for (Chunk* list : {current_, spare_}) {
+            while (list) {
+                Chunk* next = list->next;
+                free_chunk(list);
+                list = next;
+            }
+        }
+        current_ = nullptr;
+        spare_ = nullptr;
+        buffer_ = nullptr;
+    }
+};
+
+using Arena = BasicArena<SilentArenaPolicy>;
+using TracingArena = BasicArena<TracingArenaPolicy>;
+using CheckedArena = BasicArena<CheckedArenaPolicy>;
+
+// RAII scratch scope: everything allocated from the arena while the scope is alive is
+// released when it ends, allocations made before it are untouched. Scopes nest.
+template <typename ArenaType>
+class ArenaScope {
+private:
+    ArenaType& arena_;
+    typename ArenaType::Marker marker_;
+
+public:
+    explicit ArenaScope(ArenaType& arena) : arena_(arena), marker_(arena.mark()) {}
+
+    ~ArenaScope() {
+        arena_.rewind(marker_);
+    }
+
+    // Non-copyable, non-movable (tied to a specific scope)
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+    ArenaScope(ArenaScope&&) = delete;
+    ArenaScope& operator=(ArenaScope&&) = delete;
+};
+
+// TODO: Implement ArenaAllocator adapter (so it works with STL containers)
+template <typename T, typename ArenaType = Arena>
+class ArenaAllocator {
+private:
+    ArenaType* arena_;
+    // Arena epoch of this copy's latest allocation. A container still holding memory from
+    // before a reset()/rewind() then can't reclaim a newer allocation at the same address.
+    uint64_t epoch_;
+
+public:
+    using value_type = T;
+
+    // TODO: Implement constructor
+    explicit ArenaAllocator(ArenaType* arena) : arena_(arena), epoch_(arena->epoch()) {
+        // Just store the arena pointer
+    }
+
+    // TODO: Implement rebind constructor
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U, ArenaType>& other) noexcept
+        : arena_(other.get_arena()), epoch_(other.epoch_) {}
+
+    // TODO: Implement allocate
+    T* allocate(size_t n) {
+        epoch_ = arena_->epoch();
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    // TODO: Implement deallocate
+    void deallocate(T* ptr, size_t n) noexcept {
+        // Hint: No-op! Arena deallocates everything at once
+        // ...except for the most recent allocation, which the arena can take back for free
+        arena_->deallocate(ptr, n * sizeof(T), epoch_);
+    }
+
+    // Grow or shrink ptr (old_n elements) to new_n elements without moving it.
+    // Only succeeds for the arena's most recent allocation.
+    bool try_extend(T* ptr, size_t old_n, size_t new_n) noexcept {
+        return arena_->try_extend(ptr, old_n * sizeof(T), new_n * sizeof(T));
+    }
+
+    // TODO: Implement rebind
+    template <typename U>
+    struct rebind {
+        using other = ArenaAllocator<U, ArenaType>;
+    };
+
+    ArenaType* get_arena() const {
+        return arena_;
+    }
+
+    // Make ArenaAllocator<U> a friend so it can access arena_
+    template <typename U, typename A>
+    friend class ArenaAllocator;
+};
+
+// TODO: Implement comparison operators
+template <typename T, typename U, typename A>
+bool operator==(const ArenaAllocator<T, A>& a, const ArenaAllocator<U, A>& b) noexcept {
+    // Hint: Two arena allocators are equal if they use the same arena
+    return a.get_arena() == b.get_arena();  // Replace this
+}
+
+template <typename T, typename U, typename A>
+bool operator!=(const ArenaAllocator<T, A>& a, const ArenaAllocator<U, A>& b) noexcept {
+    return a.get_arena() != b.get_arena();  // Replace this
+}
+
+// =============================================================================
+// Exercise 3: ⭐⭐⭐ Thread-Safe Pool Allocator
+// =============================================================================
+
+/*
+ * GOAL: Make the pool allocator thread-safe for concurrent allocations
+ *
+ * Requirements:
+ * - Multiple threads can allocate/deallocate concurrently
+ * - Use fine-grained locking or lock-free techniques
+ * - Maintain performance under contention
+ */
+
+// Pool allocators rebound from one another (ThreadSafePoolAllocator, LockFreePoolAllocator)
+// share a group holding one pool state per block type, so every container built from the same
+// allocator reuses the same pools
+class PoolStateGroup {
+public:
+    template <typename State>
+    std::shared_ptr<State> state_for() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::shared_ptr<void>& slot = states_[typeid(State)];
+        if (!slot) {
+            slot = std::make_shared<State>();
+        }
+        return std::static_pointer_cast<State>(slot);
+    }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::type_index, std::shared_ptr<void>> states_;
+};
+
+// An allocator's handle on its state: the group plus a cached pointer to the state, which
+// the group keeps alive. Copying and rebinding only copy the group, so they can't throw (the
+// allocator requirements demand that); state_for() runs on first use instead. Racing first
+// uses resolve to the same state, so the cache needs no lock.
+template <typename State>
+class PoolStateRef {
+public:
+    explicit PoolStateRef(std::shared_ptr<PoolStateGroup> group) noexcept
+        : group_(std::move(group)) {}
+
+    PoolStateRef(const PoolStateRef& other) noexcept
+        : group_(other.group_), state_(other.state_.load(std::memory_order_acquire)) {}
+
+    PoolStateRef& operator=(const PoolStateRef& other) noexcept {
+        group_ = other.group_;
+        state_.store(other.state_.load(std::memory_order_acquire), std::memory_order_release);
+        return *this;
+    }
+
+    State* operator->() const {
+        return &**this;
+    }
+
+    State& operator*() const {
+        State* state = state_.load(std::memory_order_acquire);
+        if (!state) [[unlikely]] {
+            state = group_->template state_for<State>().get();
+            state_.store(state, std::memory_order_release);
+        }
+        return *state;
+    }
+
+    // Owning pointer, e.g. for a weak_ptr that notices when the group is gone
+    std::shared_ptr<State> shared() const {
+        return group_->template state_for<State>();
+    }
+
+    const std::shared_ptr<PoolStateGroup>& group() const noexcept {
+        return group_;
+    }
+
+private:
+    std::shared_ptr<PoolStateGroup> group_;
+    mutable std::atomic<State*> state_{nullptr};
+};
+
+template <typename T, size_t PoolSize = 1024, size_t MagazineSize = 64>
+class ThreadSafePoolAllocator {
+private:
+    // TODO: Add thread-safety primitives
+    // Options:
+    // 1. std::mutex for simple locking
+    // 2. std::atomic for lock-free free list
+    // 3. Thread-local pools for best performance
+    //
+    // We combine 1 and 3: every thread keeps a bounded "magazine" of free blocks in front of
+    // the shared PoolState and only takes a mutex to move half a magazine at a time.
+    // MagazineSize == 0 keeps the plain lock-per-call behaviour (useful for comparison).
+    //
+    // The shared state is split per NUMA node (see NumaTopology): each node has its own
+    // free list, chunks and mutex. Threads allocate from their own node; a block freed on
+    // another node goes back to the node that owns it, found from its chunk header.
+    // Chunks are mapped directly (MmapPageProvider), so a node binding covers only that
+    // mapping and goes away with it, instead of sticking to malloc heap pages.
+
+    union Block {
+        T element;
+        Block* next;
+    };
+
+    // Chunks are chunk_bytes() long and aligned to their size, so masking a block's address
+    // finds the header of its chunk
+    struct Pool {
+        Pool* next;
+        size_t node;
+    };
+
+    static_assert(std::has_single_bit(PoolSize), "PoolSize must be a power of two");
+
+    static constexpr size_t header_size =
+        (sizeof(Pool) + alignof(Block) - 1) / alignof(Block) * alignof(Block);
+    static_assert(PoolSize > header_size && (PoolSize - header_size) / sizeof(Block) > 0,
+                  "PoolSize too small for T");
+
+    // PoolSize, or one page if that is larger: NumaTopology::prefer_node() only places whole
+    // pages, so a smaller chunk would never be bound to its node
+    static size_t chunk_bytes() {
+        static const size_t bytes = std::max(PoolSize, NumaTopology::page_size());
+        return bytes;
+    }
+
+    static size_t blocks_per_pool() {
+        return (chunk_bytes() - header_size) / sizeof(Block);
+    }
+
+    static constexpr size_t batch_size = MagazineSize / 2 > 0 ? MagazineSize / 2 : 1;
+
+    // One per node, on its own cache line so nodes don't contend through false sharing
+    struct alignas(64) NodePool {
+        std::mutex mutex_;
+        Block* free_list_ = nullptr;
+        Pool* pools_ = nullptr;
+        std::atomic<size_t> pool_count_{0};  // Written under mutex_, read by reserved_bytes()
+    };
+
+    // Blocks of one other node waiting to be sent home
+    struct RemoteBatch {
+        Block* head = nullptr;
+        Block* tail = nullptr;
+        size_t count = 0;
+    };
+
+    // One per (thread, PoolState). Everything but the counters is only touched by the owning
+    // thread; the counters are single-writer atomics so the destructor can sum them from
+    // anywhere. free_list only ever holds blocks of `node`.
+    struct Magazine {
+        Block* free_list = nullptr;
+        size_t count = 0;
+        size_t node = 0;
+        std::vector<RemoteBatch> remote;
+        std::atomic<size_t> allocated{0};
+        std::atomic<size_t> deallocated{0};
+    };
+
+#if IMPSTUDY_HAS_MMAN
+    using ChunkPages = MmapPageProvider;
+#else
+    using ChunkPages = HeapPageProvider;
+#endif
+
+    struct PoolState {
+        ChunkPages pages_;  // Thread-safe; one mapping per chunk
+
+        // Fixed for the state's lifetime, so indexing needs no lock
+        std::vector<std::unique_ptr<NodePool>> nodes_;
+
+        // CHANGE: Make counters atomic
+        std::atomic<size_t> total_allocated_{0};
+        std::atomic<size_t> total_deallocated_{0};
+
+        // Owned here so a magazine never outlives the pools it caches. A thread that exits
+        // before the state dies retires its magazine: counters folded into the totals above.
+        std::mutex magazines_mutex_;
+        std::vector<std::unique_ptr<Magazine>> magazines_;
+
+        // Never reused, so a stale thread-local entry can't match a new state at the same address
+        const uint64_t id_ = next_state_id();
+
+        PoolState() : nodes_(NumaTopology::node_count()) {
+            for (auto& node : nodes_) {
+                node = std::make_unique<NodePool>();
+            }
+        }
+
+        ~PoolState() {
+            for (auto& node : nodes_) {
+                while (node->pools_) {
+                    Pool* next = node->pools_->next;
+                    pages_.deallocate_pages(node->pools_, chunk_bytes(), chunk_bytes());
+                    node->pools_ = next;
+                }
+            }
+
+            size_t allocated = total_allocated_.load();
+            size_t deallocated = total_deallocated_.load();
+            for (const auto& mag : magazines_) {
+                allocated += mag->allocated.load(std::memory_order_relaxed);
+                deallocated += mag->deallocated.load(std::memory_order_relaxed);
+            }
+
+            // Print statistics
+            std::cout << "🏊 PoolAllocator destroyed\n";
+            std::cout << "   Allocated: " << allocated << "\n";
+            std::cout << "   Deallocated: " << deallocated << "\n";
+
+            // Check for leaks
+            if (allocated != deallocated) {
+                std::cout << "⚠️  Memory leak: " << (allocated - deallocated)
+                          << " objects not freed!\n";
+            }
+        }
+    };
+
+    struct CacheEntry {
+        uint64_t state_id;
+        Magazine* magazine;
+        std::weak_ptr<PoolState> owner;
+    };
+
+    // Thread-local index of this thread's magazines. On thread exit every magazine whose
+    // PoolState is still alive hands its blocks back to their nodes and is retired, so
+    // short-lived threads don't pile up magazines in a long-lived state.
+    struct ThreadCache {
+        std::vector<CacheEntry> entries;
+
+        ~ThreadCache() {
+            for (auto& entry : entries) {
+                if (auto state = entry.owner.lock()) {
+                    retire(*state, entry.magazine);
+                }
+            }
+        }
+    };
+
+    // Add member variables
+    PoolStateRef<PoolState> state_;
+
+public:
+    using value_type = T;
+
+    // TODO: Implement thread-safe constructor
+    ThreadSafePoolAllocator() : state_(std::make_shared<PoolStateGroup>()) {
+        std::cout << "🔒 ThreadSafePoolAllocator: " << typeid(T).name() << "\n";
+    }
+
+    // Rebinding (e.g. to a list node) joins the source's group; the node pool is looked up
+    // on first use, so rebinding can't throw
+    template <typename U>
+    ThreadSafePoolAllocator(
+        const ThreadSafePoolAllocator<U, PoolSize, MagazineSize>& other) noexcept
+        : state_(other.state_.group()) {}
+
+    // TODO: Implement thread-safe destructor
+    ~ThreadSafePoolAllocator() = default;
+
+    // TODO: Implement thread-safe allocate
+    T* allocate(size_t n) {
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        if constexpr (MagazineSize == 0) {
+            size_t index = local_node();
+            NodePool& node = *state_->nodes_[index];
+
+            // LOCK THE MUTEX!
+            std::lock_guard<std::mutex> lock(node.mutex_);
+
+            if (!node.free_list_) {
+                expand_pool(node, index);  // Called with lock held
+            }
+
+            Block* block = node.free_list_;
+            node.free_list_ = block->next;
+            state_->total_allocated_.fetch_add(1);  // Atomic increment
+
+            return reinterpret_cast<T*>(block);
+        } else {
+            Magazine& mag = local_magazine();
+            if (!mag.free_list) {
+                refill(mag);  // Only path that locks
+            }
+
+            Block* block = mag.free_list;
+            mag.free_list = block->next;
+            mag.count--;
+            bump(mag.allocated);
+
+            return reinterpret_cast<T*>(block);
+        }
+    }
+
+    // TODO: Implement thread-safe deallocate
+    void deallocate(T* ptr, size_t n) {
+        // Hints:
+        // Option 1 (Simple): Lock mutex, return to free list, unlock
+        // Option 2 (Advanced): Use atomic CAS for lock-free deallocation
+        if (n != 1) {
+            ::operator delete(ptr);
+            return;
+        }
+
+        Block* block = reinterpret_cast<Block*>(ptr);
+
+        if constexpr (MagazineSize == 0) {
+            NodePool& node = *state_->nodes_[owner_node(block)];
+
+            // LOCK THE MUTEX!
+            std::lock_guard<std::mutex> lock(node.mutex_);
+
+            block->next = node.free_list_;
+            node.free_list_ = block;
+            state_->total_deallocated_.fetch_add(1);
+        } else {
+            // Blocks freed by any thread go to that thread's magazine for *this* state,
+            // so they always end up back in the pool that owns them.
+            Magazine& mag = local_magazine();
+            bump(mag.deallocated);
+
+            // Single node: skip reading the chunk header
+            if (state_->nodes_.size() > 1) {
+                size_t owner = owner_node(block);
+                if (owner != mag.node) {
+                    free_remote(mag, owner, block);
+                    return;
+                }
+            }
+
+            block->next = mag.free_list;
+            mag.free_list = block;
+            mag.count++;
+
+            if (mag.count >= MagazineSize) {
+                flush(mag);
+            }
+        }
+    }
+
+    // Batch versions, for callers that allocate or free many objects at once. allocate_n
+    // empties this thread's magazine first and takes the rest from the node's free list
+    // under one lock. deallocate_n links the span into one chain per owning node and
+    // splices each chain in with one lock.
+    void allocate_n(std::span<T*> out) {
+        size_t filled = 0;
+        size_t index = 0;
+        Magazine* mag = nullptr;
+        if constexpr (MagazineSize == 0) {
+            index = local_node();
+        } else {
+            mag = &local_magazine();
+            for (; filled < out.size() && mag->free_list; filled++) {
+                out[filled] = reinterpret_cast<T*>(mag->free_list);
+                mag->free_list = mag->free_list->next;
+                mag->count--;
+            }
+            index = mag->node;
+        }
+
+        if (filled < out.size()) {
+            NodePool& node = *state_->nodes_[index];
+            std::lock_guard<std::mutex> lock(node.mutex_);
+            try {
+                for (; filled < out.size(); filled++) {
+                    if (!node.free_list_) {
+                        expand_pool(node, index);
+                    }
+                    Block* block = node.free_list_;
+                    node.free_list_ = block->next;
+                    out[filled] = reinterpret_cast<T*>(block);
+                }
+            } catch (...) {
+                // Hand nothing out. Magazine blocks belong to this node too, so everything
+                // taken so far goes straight back onto its free list.
+                for (size_t i = filled; i-- > 0;) {
+                    Block* block = reinterpret_cast<Block*>(out[i]);
+                    block->next = node.free_list_;
+                    node.free_list_ = block;
+                }
+                throw;
+            }
+        }
+
+        if constexpr (MagazineSize == 0) {
+            state_->total_allocated_.fetch_add(out.size());
+        } else {
+            bump(mag->allocated, out.size());
+        }
+    }
+
+    void deallocate_n(std::span<T* const> ptrs) {
+        if (ptrs.empty()) {
+            return;
+        }
+
+        if (state_->nodes_.size() == 1) {
+            for (size_t i = 0; i + 1 < ptrs.size(); i++) {
+                reinterpret_cast<Block*>(ptrs[i])->next = reinterpret_cast<Block*>(ptrs[i + 1]);
+            }
+            push_chain(*state_->nodes_[0], reinterpret_cast<Block*>(ptrs.front()),
+                       reinterpret_cast<Block*>(ptrs.back()));
+        } else {
+            std::vector<RemoteBatch> chains(state_->nodes_.size());
+            for (T* ptr : ptrs) {
+                Block* block = reinterpret_cast<Block*>(ptr);
+                RemoteBatch& chain = chains[owner_node(block)];
+                block->next = chain.head;
+                if (!chain.head) {
+                    chain.tail = block;
+                }
+                chain.head = block;
+            }
+            for (size_t owner = 0; owner < chains.size(); owner++) {
+                if (chains[owner].head) {
+                    push_chain(*state_->nodes_[owner], chains[owner].head, chains[owner].tail);
+                }
+            }
+        }
+
+        if constexpr (MagazineSize == 0) {
+            state_->total_deallocated_.fetch_add(ptrs.size());
+        } else {
+            bump(local_magazine().deallocated, ptrs.size());
+        }
+    }
+
+    template <typename U>
+    struct rebind {
+        using other = ThreadSafePoolAllocator<U, PoolSize, MagazineSize>;
+    };
+
+    // Identifies the state group; equal allocators can free each other's blocks
+    const void* pool_id() const {
+        return state_.group().get();
+    }
+
+    // Magazines of threads that have used this state and not exited yet
+    size_t magazine_count() const {
+        std::lock_guard<std::mutex> lock(state_->magazines_mutex_);
+        return state_->magazines_.size();
+    }
+
+    // Nodes this allocator's pools are split over (NumaTopology::node_count() at creation)
+    size_t node_count() const {
+        return state_->nodes_.size();
+    }
+
+    // Node whose pool owns a block returned by allocate(1)
+    size_t node_of(const T* ptr) const {
+        return owner_node(reinterpret_cast<const Block*>(ptr));
+    }
+
+    // Blocks sitting on another node's shared free list; always 0 unless the routing breaks
+    size_t misplaced_blocks() const {
+        size_t misplaced = 0;
+        for (size_t index = 0; index < state_->nodes_.size(); index++) {
+            NodePool& node = *state_->nodes_[index];
+            std::lock_guard<std::mutex> lock(node.mutex_);
+            for (const Block* block = node.free_list_; block; block = block->next) {
+                misplaced += owner_node(block) != index;
+            }
+        }
+        return misplaced;
+    }
+
+    // Chunks the kernel reports on a different real node than the one they were bound to;
+    // 0 unless prefer_node() was skipped or the node ran out of memory. Always 0 in fake mode.
+    size_t misplaced_chunks() const {
+        size_t misplaced = 0;
+        for (size_t index = 0; index < state_->nodes_.size(); index++) {
+            NodePool& node = *state_->nodes_[index];
+            std::lock_guard<std::mutex> lock(node.mutex_);
+            for (const Pool* pool = node.pools_; pool; pool = pool->next) {
+                std::optional<size_t> resident = NumaTopology::resident_node(pool);
+                misplaced += resident && *resident != index;
+            }
+        }
+        return misplaced;
+    }
+
+    // Committed chunk memory across all nodes, free blocks included
+    size_t reserved_bytes() const {
+        size_t chunks = 0;
+        for (const auto& node : state_->nodes_) {
+            chunks += node->pool_count_.load(std::memory_order_relaxed);
+        }
+        return chunks * chunk_bytes();
+    }
+
+    // Free chunks whose blocks are all back on their node's free list until at most `bytes`
+    // stay reserved; returns the bytes freed. Blocks cached in thread magazines count as live.
+    // Takes one node lock at a time, so it can run alongside allocation (BackgroundTrimmer).
+    size_t shrink_to(size_t bytes) {
+        size_t released = 0;
+        for (auto& node : state_->nodes_) {
+            size_t reserved = reserved_bytes();
+            if (reserved <= bytes) {
+                break;
+            }
+
+            std::vector<Pool*> empty;
+            {
+                std::lock_guard<std::mutex> lock(node->mutex_);
+                empty = unlink_empty_chunks(node->pools_, node->free_list_, blocks_per_pool(),
+                                            (reserved - bytes + chunk_bytes() - 1) / chunk_bytes(),
+                                            [](const Block* block) { return chunk_of(block); });
+                node->pool_count_.fetch_sub(empty.size(), std::memory_order_relaxed);
+            }
+            for (Pool* pool : empty) {
+                state_->pages_.deallocate_pages(pool, chunk_bytes(), chunk_bytes());
+            }
+            released += empty.size() * chunk_bytes();
+        }
+        return released;
+    }
+
+    size_t trim() {
+        return shrink_to(0);
+    }
+
+    template <typename U, size_t P, size_t M>
+    friend class ThreadSafePoolAllocator;
+
+private:
+    static uint64_t next_state_id() {
+        static std::atomic<uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // Single writer: a relaxed load/store pair is enough and avoids a locked RMW
+    static void bump(std::atomic<size_t>& counter, size_t n = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    static const Pool* chunk_of(const Block* block) {
+        uintptr_t chunk = reinterpret_cast<uintptr_t>(block) & ~(uintptr_t{chunk_bytes()} - 1);
+        return reinterpret_cast<const Pool*>(chunk);
+    }
+
+    static size_t owner_node(const Block* block) {
+        return chunk_of(block)->node;
+    }
+
+    // The fake node count may have changed since this state was created
+    size_t local_node() const {
+        return NumaTopology::current_node() % state_->nodes_.size();
+    }
+
+    static void push_chain(NodePool& node, Block* first, Block* last) {
+        std::lock_guard<std::mutex> lock(node.mutex_);
+        last->next = node.free_list_;
+        node.free_list_ = first;
+    }
+
+    // Hand every block cached in a magazine back to its node
+    static void drain(PoolState& state, Magazine& mag) {
+        if (mag.free_list) {
+            Block* last = mag.free_list;
+            while (last->next) {
+                last = last->next;
+            }
+            push_chain(*state.nodes_[mag.node], mag.free_list, last);
+            mag.free_list = nullptr;
+            mag.count = 0;
+        }
+        for (size_t owner = 0; owner < mag.remote.size(); owner++) {
+            RemoteBatch& batch = mag.remote[owner];
+            if (batch.head) {
+                push_chain(*state.nodes_[owner], batch.head, batch.tail);
+                batch = {};
+            }
+        }
+    }
+
+    // Drain, fold the counters into the state's totals and free the magazine
+    static void retire(PoolState& state, Magazine* mag) {
+        drain(state, *mag);
+
+        std::lock_guard<std::mutex> lock(state.magazines_mutex_);
+        state.total_allocated_.fetch_add(mag->allocated.load(std::memory_order_relaxed),
+                                         std::memory_order_relaxed);
+        state.total_deallocated_.fetch_add(mag->deallocated.load(std::memory_order_relaxed),
+                                           std::memory_order_relaxed);
+        std::erase_if(state.magazines_,
+                      [mag](const std::unique_ptr<Magazine>& owned) { return owned.get() == mag; });
+    }
+
+    static ThreadCache& thread_cache() {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+    Magazine& local_magazine() {
+        ThreadCache& cache = thread_cache();
+        for (auto& entry : cache.entries) {
+            if (entry.state_id == state_->id_) {
+                return *entry.magazine;
+            }
+        }
+        return register_magazine(cache);
+    }
+
+    Magazine& register_magazine(ThreadCache& cache) {
+        // Drop entries for states that have since been destroyed
+        std::erase_if(cache.entries, [](const CacheEntry& e) { return e.owner.expired(); });
+
+        auto owned = std::make_unique<Magazine>();
+        owned->node = local_node();
+        owned->remote.resize(state_->nodes_.size());
+
+        Magazine* mag = owned.get();
+        {
+            std::lock_guard<std::mutex> lock(state_->magazines_mutex_);
+            state_->magazines_.push_back(std::move(owned));
+        }
+        cache.entries.push_back({state_->id_, mag, state_.shared()});
+        return *mag;
+    }
+
+    // Move up to batch_size blocks from the node's shared free list into the magazine
+    void refill(Magazine& mag) {
+        NodePool& node = *state_->nodes_[mag.node];
+        std::lock_guard<std::mutex> lock(node.mutex_);
+
+        if (!node.free_list_) {
+            expand_pool(node, mag.node);
+        }
+
+        Block* first = node.free_list_;
+        Block* last = first;
+        size_t taken = 1;
+        while (taken < batch_size && last->next) {
+            last = last->next;
+            taken++;
+        }
+
+        node.free_list_ = last->next;
+        last->next = mag.free_list;
+        mag.free_list = first;
+        mag.count += taken;
+    }
+
+    // Return batch_size blocks to the node's free list; the chain is cut outside the lock
+    void flush(Magazine& mag) {
+        Block* first = mag.free_list;
+        Block* last = first;
+        for (size_t i = 1; i < batch_size; i++) {
+            last = last->next;
+        }
+        mag.free_list = last->next;
+        mag.count -= batch_size;
+
+        push_chain(*state_->nodes_[mag.node], first, last);
+    }
+
+    // Another node's block: collect a batch of them, then return it with one lock
+    void free_remote(Magazine& mag, size_t owner, Block* block) {
+        RemoteBatch& batch = mag.remote[owner];
+        block->next = batch.head;
+        if (!batch.head) {
+            batch.tail = block;
+        }
+        batch.head = block;
+
+        if (++batch.count >= batch_size) {
+            push_chain(*state_->nodes_[owner], batch.head, batch.tail);
+            batch = {};
+        }
+    }
+
+    //! MUST be called with node.mutex_ held! Nothing here may block, print or take another
+    //! lock; reserved_bytes() reports the growth instead.
+    void expand_pool(NodePool& node, size_t index) {
+        // A fresh mapping, bound before its first page is touched
+        void* raw = state_->pages_.allocate_pages(chunk_bytes(), chunk_bytes());
+        NumaTopology::prefer_node(raw, chunk_bytes(), index);
+
+        Pool* new_pool = static_cast<Pool*>(raw);
+        new_pool->next = node.pools_;
+        new_pool->node = index;
+        node.pools_ = new_pool;
+        node.pool_count_.fetch_add(1, std::memory_order_relaxed);
+
+        Block* blocks = reinterpret_cast<Block*>(static_cast<char*>(raw) + header_size);
+        size_t count = blocks_per_pool();
+        for (size_t i = 0; i < count - 1; i++) {
+            blocks[i].next = &blocks[i + 1];
+        }
+        blocks[count - 1].next = node.free_list_;
+        node.free_list_ = blocks;
+    }
+};
+
+template <typename T, typename U, size_t PoolSize, size_t MagazineSize>
+bool operator==(const ThreadSafePoolAllocator<T, PoolSize, MagazineSize>& a,
+                const ThreadSafePoolAllocator<U, PoolSize, MagazineSize>& b) noexcept {
+    return a.pool_id() == b.pool_id();
+}
+
+template <typename T, typename U, size_t PoolSize, size_t MagazineSize>
+bool operator!=(const ThreadSafePoolAllocator<T, PoolSize, MagazineSize>& a,
+                const ThreadSafePoolAllocator<U, PoolSize, MagazineSize>& b) noexcept {
+    return !(a == b);
+}
+
+// Background trim policy: calls shrink_to(retain_bytes) on (a copy of) an allocator every
+// `interval` from its own thread until destroyed. The allocator's shrink_to() must be safe
+// to call concurrently with allocation, i.e. ThreadSafePoolAllocator.
+template <typename Allocator>
+class BackgroundTrimmer {
+public:
+    BackgroundTrimmer(const Allocator& alloc, std::chrono::milliseconds interval,
+                      size_t retain_bytes = 0)
+        : alloc_(alloc), thread_([this, interval, retain_bytes](std::stop_token stop) {
+              std::mutex mutex;
+              std::unique_lock<std::mutex> lock(mutex);
+              // wait_for() returns early once the destructor requests a stop
+              while (!wakeup_.wait_for(lock, stop, interval,
+                                       [&] { return stop.stop_requested(); })) {
+                  released_bytes_.fetch_add(alloc_.shrink_to(retain_bytes));
+                  passes_.fetch_add(1);
+              }
+          }) {}
+
+    BackgroundTrimmer(const BackgroundTrimmer&) = delete;
+    BackgroundTrimmer& operator=(const BackgroundTrimmer&) = delete;
+
+    size_t released_bytes() const {
+        return released_bytes_.load();
+    }
+
+    size_t passes() const {
+        return passes_.load();
+    }
+
+private:
+    Allocator alloc_;
+    std::condition_variable_any wakeup_;
+    std::atomic<size_t> released_bytes_{0};
+    std::atomic<size_t> passes_{0};
+    std::jthread thread_;  // Last, so it is stopped and joined before the rest goes away
+};
+
+// =============================================================================
+// Exercise 4: 🌟 BONUS - Tracking Allocator (Debugging)
+// =============================================================================
+
+/*
+ * GOAL: Create a wrapper allocator that tracks all allocations
+ *
+ * Useful for:
+ * - Finding memory leaks
+ * - Profiling memory usage
+ * - Understanding allocation patterns
+ */
+
+// Process-wide thread numbering for per-thread statistics. Every live thread leases a
+// distinct slot below max_slots (returned when the thread exits), so whoever owns slot i
+// is the only writer of shard i. Threads beyond max_slots share the overflow slot, and so
+// does a thread still running thread_local destructors after its lease was given back
+// (its slot may already belong to another thread).
+class ThreadSlots {
+public:
+    static constexpr size_t max_slots = 256;
+    static constexpr size_t overflow_slot = max_slots;
+
+    static size_t current() noexcept {
+        // Trivially destructible, so still readable after the lease is destroyed
+        thread_local bool released = false;
+        if (released) [[unlikely]] {
+            return overflow_slot;
+        }
+        thread_local Lease lease(released);
+        return lease.index;
+    }
+
+private:
+    struct Registry {
+        std::mutex mutex;
+        std::vector<size_t> free_slots;
+        size_t next_unused = 0;
+    };
+
+    static Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    struct Lease {
+        size_t index = overflow_slot;
+        bool& released;
+
+        explicit Lease(bool& released) : released(released) {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            if (!r.free_slots.empty()) {
+                index = r.free_slots.back();
+                r.free_slots.pop_back();
+            } else if (r.next_unused < max_slots) {
+                index = r.next_unused++;
+            }
+        }
+
+        ~Lease() {
+            released = true;
+            if (index != overflow_slot) {
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.free_slots.push_back(index);
+            }
+        }
+    };
+};
+
+// Allocation statistics split into one cache-line-aligned shard per thread slot. A thread is
+// the only writer of its shard, so updates are plain relaxed load/store pairs (no locked
+// RMW, no shared line to ping-pong); totals are summed only when someone asks for them.
+//
+// Peak usage cannot be exact without a global counter. Instead a shard refreshes the global
+// peak every peak_refresh_bytes it allocates, so snapshot().peak_usage (and a
+// TrackingAllocator's get_peak_usage()) can under-report the true peak by up to
+// peak_refresh_bytes per shard. Callers comparing against a known high-water mark must
+// allow for that slack.
+//
+// Profiling: every allocation lands in a log2 size histogram. With set_sampling(n) every
+// n-th allocation per thread is also timed until it is freed (lifetime histogram) and can
+// record its call stack. Sampling costs a locked table lookup per free while it is enabled.
+class TrackingCounters {
+public:
+    static constexpr size_t cache_line_size = 64;
+    static constexpr size_t peak_refresh_bytes = 16 * 1024;
+    // Bucket 0 holds 0, bucket i holds [2^(i-1), 2^i); the last bucket takes everything above
+    static constexpr size_t num_buckets = 40;
+    static constexpr int max_frames = 16;
+
+    struct CallSite {
+        std::vector<void*> frames;
+        size_t count = 0;
+        size_t bytes = 0;
+    };
+
+    struct Snapshot {
+        size_t total_allocated = 0;
+        size_t total_freed = 0;
+        size_t allocation_count = 0;
+        size_t deallocation_count = 0;
+        size_t current_usage = 0;
+        size_t peak_usage = 0;                                 // see "Peak usage" above
+        std::array<size_t, num_buckets> size_histogram{};      // bytes per allocation
+        std::array<size_t, num_buckets> lifetime_histogram{};  // ns, sampled allocations only
+        std::vector<CallSite> call_sites;                      // sampled allocations only
+    };
+
+private:
+    struct alignas(cache_line_size) Shard {
+        std::atomic<size_t> bytes_allocated{0};
+        std::atomic<size_t> bytes_freed{0};
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> deallocations{0};
+        std::atomic<size_t> sample_countdown{0};
+        std::atomic<size_t> size_histogram[num_buckets] = {};
+    };
+
+    // Sampled live allocations, split by address so frees on different threads rarely collide
+    struct alignas(cache_line_size) SampleShard {
+        mutable std::mutex mutex;
+        std::unordered_map<const void*, uint64_t> start_ns;
+        std::array<size_t, num_buckets> lifetime_histogram{};
+    };
+    static constexpr size_t num_sample_shards = 16;
+
+    Shard shards_[ThreadSlots::max_slots + 1];
+    alignas(cache_line_size) std::atomic<size_t> peak_usage_{0};
+
+    std::atomic<size_t> sample_every_{0};
+    std::atomic<bool> capture_call_sites_{false};
+    std::atomic<size_t> sampled_live_{0};
+    SampleShard sample_shards_[num_sample_shards];
+
+    mutable std::mutex call_site_mutex_;
+    std::map<std::vector<void*>, CallSite> call_sites_;
+
+public:
+    static size_t bucket_for(uint64_t value) noexcept {
+        return std::min<size_t>(std::bit_width(value), num_buckets - 1);
+    }
+
+    // Smallest value that lands in bucket i
+    static uint64_t bucket_floor(size_t i) noexcept {
+        return i == 0 ? 0 : uint64_t{1} << (i - 1);
+    }
+
+    // every_n == 0 turns sampling off. Call-site capture needs <execinfo.h> (glibc).
+    void set_sampling(size_t every_n, bool capture_call_sites = false) {
+        capture_call_sites_.store(capture_call_sites, std::memory_order_relaxed);
+        sample_every_.store(every_n, std::memory_order_relaxed);
+    }
+
+    void record_allocation(const void* ptr, size_t bytes) noexcept {
+        size_t slot = ThreadSlots::current();
+        Shard& shard = shards_[slot];
+        size_t before = add(slot, shard.bytes_allocated, bytes);
+        add(slot, shard.allocations, 1);
+        add(slot, shard.size_histogram[bucket_for(bytes)], 1);
+
+        // Crossed a peak_refresh_bytes boundary on this shard: publish the current total
+        if ((before ^ (before + bytes)) >= peak_refresh_bytes) [[unlikely]] {
+            refresh_peak();
+        }
+
+        size_t every = sample_every_.load(std::memory_order_relaxed);
+        if (every != 0) [[unlikely]] {
+            if (add(slot, shard.sample_countdown, 1) + 1 >= every) {
+                shard.sample_countdown.store(0, std::memory_order_relaxed);
+                begin_sample(ptr, bytes);
+            }
+        }
+    }
+
+    void record_deallocation(const void* ptr, size_t bytes) noexcept {
+        size_t slot = ThreadSlots::current();
+        Shard& shard = shards_[slot];
+        add(slot, shard.bytes_freed, bytes);
+        add(slot, shard.deallocations, 1);
+
+        if (sampled_live_.load(std::memory_order_relaxed) != 0) [[unlikely]] {
+            end_sample(ptr);
+        }
+    }
+
+    Snapshot snapshot() const {
+        Snapshot s;
+        for (const Shard& shard : shards_) {
+            s.total_allocated += shard.bytes_allocated.load(std::memory_order_relaxed);
+            s.total_freed += shard.bytes_freed.load(std::memory_order_relaxed);
+            s.allocation_count += shard.allocations.load(std::memory_order_relaxed);
+            s.deallocation_count += shard.deallocations.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < num_buckets; ++i) {
+                s.size_histogram[i] += shard.size_histogram[i].load(std::memory_order_relaxed);
+            }
+        }
+        // A free can be summed before its allocation while other threads are running
+        s.current_usage = s.total_allocated > s.total_freed ? s.total_allocated - s.total_freed : 0;
+        s.peak_usage = std::max(peak_usage_.load(std::memory_order_relaxed), s.current_usage);
+
+        for (const SampleShard& shard : sample_shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (size_t i = 0; i < num_buckets; ++i) {
+                s.lifetime_histogram[i] += shard.lifetime_histogram[i];
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(call_site_mutex_);
+            for (const auto& [frames, site] : call_sites_) {
+                s.call_sites.push_back(site);
+            }
+        }
+        std::sort(s.call_sites.begin(), s.call_sites.end(),
+                  [](const CallSite& a, const CallSite& b) { return a.bytes > b.bytes; });
+        return s;
+    }
+
+    // Only meaningful while no other thread is allocating through these counters
+    void reset() {
+        for (Shard& shard : shards_) {
+            shard.bytes_allocated.store(0, std::memory_order_relaxed);
+            shard.bytes_freed.store(0, std::memory_order_relaxed);
+            shard.allocations.store(0, std::memory_order_relaxed);
+            shard.deallocations.store(0, std::memory_order_relaxed);
+            shard.sample_countdown.store(0, std::memory_order_relaxed);
+            for (auto& bucket : shard.size_histogram) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+        peak_usage_.store(0, std::memory_order_relaxed);
+
+        for (SampleShard& shard : sample_shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.start_ns.clear();
+            shard.lifetime_histogram.fill(0);
+        }
+        sampled_live_.store(0, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(call_site_mutex_);
+        call_sites_.clear();
+    }
+
+    // Machine-readable export, one object per counter set
+    void write_json(std::ostream& out, const std::string& name) const {
+        Snapshot s = snapshot();
+        out << "{\"name\": \"" << json_escape(name) << "\""
+            << ", \"total_allocated\": " << s.total_allocated
+            << ", \"total_freed\": " << s.total_freed
+            << ", \"allocation_count\": " << s.allocation_count
+            << ", \"deallocation_count\": " << s.deallocation_count
+            << ", \"current_usage\": " << s.current_usage << ", \"peak_usage\": " << s.peak_usage;
+
+        auto write_histogram = [&](const char* key, const std::array<size_t, num_buckets>& hist) {
+            out << ", \"" << key << "\": [";
+            bool first = true;
+            for (size_t i = 0; i < num_buckets; ++i) {
+                if (hist[i] == 0) {
+                    continue;
+                }
+                out << (first ? "" : ", ") << "{\"min\": " << bucket_floor(i)
+                    << ", \"count\": " << hist[i] << "}";
+                first = false;
+            }
+            out << "]";
+        };
+        write_histogram("size_histogram_bytes", s.size_histogram);
+        write_histogram("lifetime_histogram_ns", s.lifetime_histogram);
+
+        out << ", \"call_sites\": [";
+        for (size_t i = 0; i < s.call_sites.size(); ++i) {
+            const CallSite& site = s.call_sites[i];
+            out << (i ? ", " : "") << "{\"count\": " << site.count << ", \"bytes\": " << site.bytes
+                << ", \"frames\": [";
+            std::vector<std::string> names = symbolize(site.frames);
+            for (size_t f = 0; f < names.size(); ++f) {
+                out << (f ? ", " : "") << "\"" << json_escape(names[f]) << "\"";
+            }
+            out << "]}";
+        }
+        out << "]}\n";
+    }
+
+    // kind,name,min,count,bytes,frames  (frames are ';'-separated, call_site rows only)
+    void write_csv(std::ostream& out, const std::string& name, bool header = true) const {
+        Snapshot s = snapshot();
+        std::string label = csv_quote(name);
+        if (header) {
+            out << "kind,name,min,count,bytes,frames\n";
+        }
+        out << "total," << label << ",0," << s.allocation_count << "," << s.total_allocated
+            << ",\n";
+        for (size_t i = 0; i < num_buckets; ++i) {
+            if (s.size_histogram[i]) {
+                out << "size," << label << "," << bucket_floor(i) << "," << s.size_histogram[i]
+                    << ",,\n";
+            }
+        }
+        for (size_t i = 0; i < num_buckets; ++i) {
+            if (s.lifetime_histogram[i]) {
+                out << "lifetime_ns," << label << "," << bucket_floor(i) << ","
+                    << s.lifetime_histogram[i] << ",,\n";
+            }
+        }
+        for (const CallSite& site : s.call_sites) {
+            std::string frames;
+            std::vector<std::string> names = symbolize(site.frames);
+            for (size_t f = 0; f < names.size(); ++f) {
+                frames += (f ? ";" : "") + names[f];
+            }
+            out << "call_site," << label << ",0," << site.count << "," << site.bytes << ","
+                << csv_quote(frames) << "\n";
+        }
+    }
+
+private:
+    // Returns the previous value
+    static size_t add(size_t slot, std::atomic<size_t>& counter, size_t delta) noexcept {
+        if (slot == ThreadSlots::overflow_slot) [[unlikely]] {
+            return counter.fetch_add(delta, std::memory_order_relaxed);
+        }
+        size_t before = counter.load(std::memory_order_relaxed);
+        counter.store(before + delta, std::memory_order_relaxed);
+        return before;
+    }
+
+    void refresh_peak() noexcept {
+        size_t current = snapshot_usage();
+        size_t old_peak = peak_usage_.load(std::memory_order_relaxed);
+        while (current > old_peak &&
+               !peak_usage_.compare_exchange_weak(old_peak, current, std::memory_order_relaxed)) {
+            // Retry
+        }
+    }
+
+    size_t snapshot_usage() const noexcept {
+        size_t allocated = 0;
+        size_t freed = 0;
+        for (const Shard& shard : shards_) {
+            allocated += shard.bytes_allocated.load(std::memory_order_relaxed);
+            freed += shard.bytes_freed.load(std::memory_order_relaxed);
+        }
+        return allocated > freed ? allocated - freed : 0;
+    }
+
+    static uint64_t now_ns() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    SampleShard& sample_shard(const void* ptr) noexcept {
+        return sample_shards_[(reinterpret_cast<uintptr_t>(ptr) >> 4) % num_sample_shards];
+    }
+
+    [[gnu::noinline]] void begin_sample(const void* ptr, size_t bytes) noexcept {
+        try {
+            {
+                SampleShard& shard = sample_shard(ptr);
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.start_ns[ptr] = now_ns();
+            }
+            sampled_live_.fetch_add(1, std::memory_order_relaxed);
+
+#if __has_include(<execinfo.h>)
+            if (capture_call_sites_.load(std::memory_order_relaxed)) {
+                void* frames[max_frames];
+                int depth = backtrace(frames, max_frames);
+                // Skip this frame; the tracking frames above it depend on inlining
+                std::vector<void*> key(frames + std::min(depth, 1), frames + depth);
+
+                std::lock_guard<std::mutex> lock(call_site_mutex_);
+                CallSite& site = call_sites_[key];
+                if (site.frames.empty()) {
+                    site.frames = key;
+                }
+                site.count++;
+                site.bytes += bytes;
+            }
+#endif
+        } catch (...) {
+            // Profiling must never make an allocation fail; drop the sample
+        }
+    }
+
+    [[gnu::noinline]] void end_sample(const void* ptr) noexcept {
+        SampleShard& shard = sample_shard(ptr);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.start_ns.find(ptr);
+        if (it == shard.start_ns.end()) {
+            return;
+        }
+        shard.lifetime_histogram[bucket_for(now_ns() - it->second)]++;
+        shard.start_ns.erase(it);
+        sampled_live_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    static std::vector<std::string> symbolize(const std::vector<void*>& frames) {
+        std::vector<std::string> names;
+#if __has_include(<execinfo.h>)
+        char** symbols = backtrace_symbols(frames.data(), static_cast<int>(frames.size()));
+        if (symbols) {
+            names.assign(symbols, symbols + frames.size());
+            free(symbols);
+            return names;
+        }
+#endif
+        for (void* frame : frames) {
+            std::ostringstream address;
+            address << frame;
+            names.push_back(address.str());
+        }
+        return names;
+    }
+
+    static std::string json_escape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                escaped += ' ';
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    // RFC 4180 field: quoted, embedded quotes doubled, so commas and line breaks survive
+    static std::string csv_quote(const std::string& text) {
+        std::string quoted = "\"";
+        for (char c : text) {
+            quoted += c;
+            if (c == '"') {
+                quoted += '"';
+            }
+        }
+        return quoted + "\"";
+    }
+};
+
+// A named set of tracking counters. Allocators hold a domain by shared_ptr and rebinding keeps
+// it, so the node allocations of std::list<int, TrackingAllocator<int>> are charged to the
+// domain the list was given instead of to whichever template the node type rebinds to.
+// Default-constructed allocators share global(); give a container, subsystem or request its
+// own domain with create("name") to see which component owns the bytes.
+class TrackingDomain {
+public:
+    static std::shared_ptr<TrackingDomain> create(std::string name) {
+        std::shared_ptr<TrackingDomain> domain(new TrackingDomain(std::move(name)));
+
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        std::erase_if(r.domains,
+                      [](const std::weak_ptr<TrackingDomain>& d) { return d.expired(); });
+        r.domains.push_back(domain);
+        return domain;
+    }
+
+    static const std::shared_ptr<TrackingDomain>& global() {
+        static const std::shared_ptr<TrackingDomain> instance = create("global");
+        return instance;
+    }
+
+    // Every domain that is still alive, in creation order
+    static std::vector<std::shared_ptr<TrackingDomain>> all() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        std::vector<std::shared_ptr<TrackingDomain>> live;
+        for (const auto& weak : r.domains) {
+            if (auto domain = weak.lock()) {
+                live.push_back(std::move(domain));
+            }
+        }
+        return live;
+    }
+
+    // One line per live domain
+    static void print_all() {
+        std::cout << "\n📊 Tracking domains\n";
+        std::cout << "  " << std::left << std::setw(20) << "domain" << std::right << std::setw(14)
+                  << "current B" << std::setw(14) << "peak B" << std::setw(12) << "allocs"
+                  << std::setw(12) << "frees" << "\n";
+        for (const auto& domain : all()) {
+            TrackingCounters::Snapshot s = domain->snapshot();
+            std::cout << "  " << std::left << std::setw(20) << domain->name() << std::right
+                      << std::setw(14) << s.current_usage << std::setw(14) << s.peak_usage
+                      << std::setw(12) << s.allocation_count << std::setw(12)
+                      << s.deallocation_count << "\n";
+        }
+    }
+
+    TrackingDomain(const TrackingDomain&) = delete;
+    TrackingDomain& operator=(const TrackingDomain&) = delete;
+
+    const std::string& name() const noexcept {
+        return name_;
+    }
+
+    TrackingCounters& counters() noexcept {
+        return counters_;
+    }
+
+    TrackingCounters::Snapshot snapshot() const {
+        return counters_.snapshot();
+    }
+
+    void print_stats() const {
+        std::cout << "\n" << std::string(60, '=') << "\n";
+        std::cout << "📊 TrackingAllocator Statistics [" << name_ << "]\n";
+        std::cout << std::string(60, '=') << "\n";
+
+        TrackingCounters::Snapshot stats = counters_.snapshot();
+        size_t total_alloc = stats.total_allocated;
+        size_t total_free = stats.total_freed;
+        size_t alloc_count = stats.allocation_count;
+        size_t dealloc_count = stats.deallocation_count;
+        size_t current = stats.current_usage;
+        size_t peak = stats.peak_usage;
+
+        std::cout << "Total allocated:     " << total_alloc << " bytes\n";
+        std::cout << "Total freed:         " << total_free << " bytes\n";
+        std::cout << "Current usage:       " << current << " bytes\n";
+        std::cout << "Peak usage:          " << peak << " bytes\n";
+        std::cout << "\n";
+        std::cout << "Allocation count:    " << alloc_count << "\n";
+        std::cout << "Deallocation count:  " << dealloc_count << "\n";
+
+        if (alloc_count > 0) {
+            std::cout << "Avg allocation size: " << (total_alloc / alloc_count) << " bytes\n";
+        }
+
+        std::cout << "\nSize histogram:\n";
+        for (size_t i = 0; i < TrackingCounters::num_buckets; ++i) {
+            if (stats.size_histogram[i]) {
+                std::cout << "  >= " << TrackingCounters::bucket_floor(i)
+                          << " bytes: " << stats.size_histogram[i] << "\n";
+            }
+        }
+
+        std::cout << "\n";
+
+        // Check for leaks
+        if (current > 0) {
+            std::cout << "⚠️  MEMORY LEAK DETECTED!\n";
+            std::cout << "   " << current << " bytes still allocated\n";
+            std::cout << "   " << (alloc_count - dealloc_count) << " allocations not freed\n";
+        } else if (total_alloc == total_free) {
+            std::cout << "✅ No memory leaks detected\n";
+        }
+
+        std::cout << std::string(60, '=') << "\n";
+    }
+
+    // Profile every n-th allocation per thread (lifetime, optionally call stack); 0 = off
+    void set_sampling(size_t every_n, bool capture_call_sites = false) {
+        counters_.set_sampling(every_n, capture_call_sites);
+    }
+
+    void write_json(std::ostream& out) const {
+        counters_.write_json(out, name_);
+    }
+
+    void write_csv(std::ostream& out, bool header = true) const {
+        counters_.write_csv(out, name_, header);
+    }
+
+    void reset_stats() {
+        counters_.reset();
+
+        std::cout << "📊 Statistics reset [" << name_ << "]\n";
+    }
+
+private:
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::weak_ptr<TrackingDomain>> domains;
+    };
+
+    static Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    explicit TrackingDomain(std::string name) : name_(std::move(name)) {}
+
+    std::string name_;
+    TrackingCounters counters_;
+};
+
+template <typename T, typename BaseAllocator = std::allocator<T>>
+class TrackingAllocator {
+private:
+    BaseAllocator base_;
+
+    // TODO: Add tracking variables
+    // Shared with every copy and rebind; counters_ caches domain_->counters() for the hot path
+    std::shared_ptr<TrackingDomain> domain_;
+    TrackingCounters* counters_;
+
+public:
+    using value_type = T;
+
+    // The domain follows the container on copy, move and swap
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    TrackingAllocator() : TrackingAllocator(TrackingDomain::global()) {}
+
+    explicit TrackingAllocator(std::shared_ptr<TrackingDomain> domain,
+                               const BaseAllocator& base = BaseAllocator())
+        : base_(base), domain_(std::move(domain)), counters_(&domain_->counters()) {}
+
+    // Rebinding (e.g. to a list node) keeps the domain and rebinds the base allocator
+    template <typename U, typename A>
+    TrackingAllocator(const TrackingAllocator<U, A>& other)
+        : base_(other.base_), domain_(other.domain_), counters_(other.counters_) {}
+
+    // TODO: Implement allocate with tracking
+    T* allocate(size_t n) {
+        // Hints:
+        // 1. Call base_.allocate(n)
+        // 2. Update all statistics
+        // 3. Print allocation info (optional, can be verbose)
+        // 4. Return pointer
+        T* ptr = base_.allocate(n);
+
+        // Track statistics
+        counters_->record_allocation(ptr, n * sizeof(T));
+
+        return ptr;
+    }
+
+    // TODO: Implement deallocate with tracking
+    void deallocate(T* ptr, size_t n) {
+        // Hints:
+        // 1. Update statistics
+        // 2. Print deallocation info (optional)
+        // 3. Call base_.deallocate(ptr, n)
+
+        // Track statistics
+        counters_->record_deallocation(ptr, n * sizeof(T));
+
+        // Call base allocator
+        base_.deallocate(ptr, n);
+    }
+
+    template <typename U>
+    struct rebind {
+        using other = TrackingAllocator<
+            U, typename std::allocator_traits<BaseAllocator>::template rebind_alloc<U>>;
+    };
+
+    const std::shared_ptr<TrackingDomain>& domain() const noexcept {
+        return domain_;
+    }
+
+    const BaseAllocator& base() const noexcept {
+        return base_;
+    }
+
+    // TODO: Implement method to print statistics
+    // Statistics are per domain, so these report everything charged to this allocator's domain
+    void print_stats() const {
+        domain_->print_stats();
+    }
+
+    void set_sampling(size_t every_n, bool capture_call_sites = false) const {
+        domain_->set_sampling(every_n, capture_call_sites);
+    }
+
+    void write_json(std::ostream& out) const {
+        domain_->write_json(out);
+    }
+
+    void write_csv(std::ostream& out, bool header = true) const {
+        domain_->write_csv(out, header);
+    }
+
+    // TODO: Implement method to reset statistics
+    void reset_stats() const {
+        domain_->reset_stats();
+    }
+
+    // Getters (each one aggregates the shards)
+    size_t get_total_allocated() const {
+        return domain_->snapshot().total_allocated;
+    }
+    size_t get_total_freed() const {
+        return domain_->snapshot().total_freed;
+    }
+    size_t get_current_usage() const {
+        return domain_->snapshot().current_usage;
+    }
+    size_t get_peak_usage() const {
+        return domain_->snapshot().peak_usage;
+    }
+    size_t get_allocation_count() const {
+        return domain_->snapshot().allocation_count;
+    }
+    size_t get_deallocation_count() const {
+        return domain_->snapshot().deallocation_count;
+    }
+
+    // Make other template instances friends
+    template <typename U, typename A>
+    friend class TrackingAllocator;
+};
+
+template <typename T, typename A, typename U, typename B>
+bool operator==(const TrackingAllocator<T, A>& a, const TrackingAllocator<U, B>& b) noexcept {
+    return a.domain() == b.domain() && a.base() == b.base();
+}
+
+template <typename T, typename A, typename U, typename B>
+bool operator!=(const TrackingAllocator<T, A>& a, const TrackingAllocator<U, B>& b) noexcept {
+    return !(a == b);
+}
+
+// =============================================================================
+// Exercise 5: 🌟 Lock-Free Pool Allocator
+// =============================================================================
+
+/*
+ * GOAL: A pool whose allocate/deallocate never take a lock, even when it grows
+ *
+ * Design:
+ * - Blocks are addressed by a 32-bit index instead of a pointer, so the free-list head
+ *   packs (tag << 32) | index into one 64-bit word. Every successful CAS bumps the tag,
+ *   which makes the classic ABA interleaving (pop A, pop B, push A) fail the CAS.
+ * - Memory lives in geometrically growing chunks (chunk c holds ChunkBlocks << c blocks)
+ *   that are only released with the pool, so reading a stale block's next index is safe.
+ * - Growth hands out never-used indices with a fetch_add; the first thread to touch a new
+ *   chunk installs it with a CAS and any loser frees its copy. No heap fallback, no mutex.
+ *
+ * The tag wraps after 2^32 operations between one thread's load and its CAS, which is
+ * far beyond any realistic preemption window.
+ */
+
+// One pool per block layout. LockFreePoolAllocators rebound from one another keep theirs in a
+// shared PoolStateGroup, so a node type freed through any rebound copy returns to its own pool.
+template <size_t BlockSize, size_t BlockAlign, size_t ChunkBlocks>
+struct LockFreePoolState {
+    // Free blocks store the next index in their first 4 bytes
+    struct alignas(BlockAlign) Block {
+        unsigned char storage[BlockSize];
+    };
+
+    // Largest chunk count whose total block count still fits a 32-bit index
+    static constexpr size_t max_chunks = 32 - std::bit_width(ChunkBlocks);
+    static constexpr uint64_t max_blocks = ChunkBlocks * ((uint64_t{1} << max_chunks) - 1);
+
+    std::atomic<uint64_t> head_{0};        // (tag << 32) | index, index 0 == empty
+    std::atomic<uint64_t> next_fresh_{0};  // Next never-used block (0-based)
+    std::atomic<Block*> chunks_[max_chunks] = {};
+
+    std::atomic<size_t> total_allocated_{0};
+    std::atomic<size_t> total_deallocated_{0};
+
+    ~LockFreePoolState() {
+        for (auto& chunk : chunks_) {
+            delete[] chunk.load();
+        }
+
+        // Print statistics
+        std::cout << "🏊 LockFreePoolAllocator destroyed\n";
+        std::cout << "   Allocated: " << total_allocated_ << "\n";
+        std::cout << "   Deallocated: " << total_deallocated_ << "\n";
+
+        // Check for leaks
+        size_t allocated = total_allocated_.load();
+        size_t deallocated = total_deallocated_.load();
+        if (allocated != deallocated) {
+            std::cout << "⚠️  Memory leak: " << (allocated - deallocated)
+                      << " objects not freed!\n";
+        }
+    }
+};
+
+template <typename T, size_t ChunkBlocks = 1024>
+class LockFreePoolAllocator {
+    static_assert(ChunkBlocks > 0 && (ChunkBlocks & (ChunkBlocks - 1)) == 0,
+                  "ChunkBlocks must be a power of two");
+
+    template <typename U, size_t>
+    friend class LockFreePoolAllocator;
+
+private:
+    using PoolState = LockFreePoolState<std::max(sizeof(T), sizeof(uint32_t)),
+                                        std::max(alignof(T), alignof(uint32_t)), ChunkBlocks>;
+    using Block = typename PoolState::Block;
+
+    static constexpr size_t max_chunks = PoolState::max_chunks;
+    static constexpr uint64_t max_blocks = PoolState::max_blocks;
+
+    PoolStateRef<PoolState> state_;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    LockFreePoolAllocator() : state_(std::make_shared<PoolStateGroup>()) {
+        std::cout << "⚛️ LockFreePoolAllocator: " << typeid(T).name() << "\n";
+    }
+
+    // Rebinding joins the same group: U's pool is shared with every other copy of the
+    // allocator, and rebinding back yields an allocator equal to the original. The pool is
+    // looked up on first use, so rebinding can't throw.
+    template <typename U>
+    LockFreePoolAllocator(const LockFreePoolAllocator<U, ChunkBlocks>& other) noexcept
+        : state_(other.state_.group()) {}
+
+    T* allocate(size_t n) {
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        uint64_t head = state_->head_.load(std::memory_order_acquire);
+        while (index_of(head) != 0) {
+            Block* block = block_at(index_of(head));
+            uint32_t next = next_of(block).load(std::memory_order_relaxed);
+
+            if (state_->head_.compare_exchange_weak(head, pack(tag_of(head) + 1, next),
+                                                    std::memory_order_acquire,
+                                                    std::memory_order_acquire)) {
+                state_->total_allocated_.fetch_add(1, std::memory_order_relaxed);
+                return reinterpret_cast<T*>(block);
+            }
+        }
+
+        // Free list empty: carve a never-used block instead of going to the heap
+        Block* block = fresh_block();
+        state_->total_allocated_.fetch_add(1, std::memory_order_relaxed);
+        return reinterpret_cast<T*>(block);
+    }
+
+    void deallocate(T* ptr, size_t n) {
+        if (n != 1) {
+            ::operator delete(ptr);
+            return;
+        }
+
+        Block* block = reinterpret_cast<Block*>(ptr);
+        uint32_t index = index_for(block);
+
+        uint64_t head = state_->head_.load(std::memory_order_relaxed);
+        do {
+            next_of(block).store(index_of(head), std::memory_order_relaxed);
+        } while (!state_->head_.compare_exchange_weak(head, pack(tag_of(head) + 1, index),
+                                                      std::memory_order_release,
+                                                      std::memory_order_relaxed));
+
+        state_->total_deallocated_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Batch versions. allocate_n detaches up to out.size() blocks from the free list with one
+    // CAS and carves any shortfall from fresh chunks with one fetch_add; deallocate_n links
+    // the span into a chain and pushes it with one CAS.
+    void allocate_n(std::span<T*> out) {
+        size_t taken = 0;
+        uint64_t head = state_->head_.load(std::memory_order_acquire);
+        while (index_of(head) != 0 && !out.empty()) {
+            // Until the CAS succeeds the walk may follow blocks that another thread has
+            // popped and overwritten meanwhile, so indices are bounds-checked before use.
+            // If the CAS does succeed nothing changed, and the walked chain was intact.
+            taken = 0;
+            uint32_t index = index_of(head);
+            while (index != 0 && taken < out.size()) {
+                Block* block = try_block_at(index);
+                if (!block) {
+                    break;
+                }
+                out[taken++] = reinterpret_cast<T*>(block);
+                index = next_of(block).load(std::memory_order_relaxed);
+            }
+
+            if (state_->head_.compare_exchange_weak(head, pack(tag_of(head) + 1, index),
+                                                    std::memory_order_acquire,
+                                                    std::memory_order_acquire)) {
+                break;
+            }
+            taken = 0;
+        }
+
+        try {
+            fresh_blocks(out.subspan(taken));
+        } catch (...) {
+            push_chain(out.first(taken));  // Hand nothing out
+            throw;
+        }
+        state_->total_allocated_.fetch_add(out.size(), std::memory_order_relaxed);
+    }
+
+    void deallocate_n(std::span<T* const> ptrs) {
+        push_chain(ptrs);
+        state_->total_deallocated_.fetch_add(ptrs.size(), std::memory_order_relaxed);
+    }
+
+    template <typename U>
+    struct rebind {
+        using other = LockFreePoolAllocator<U, ChunkBlocks>;
+    };
+
+    size_t allocated_count() const {
+        return state_->total_allocated_.load();
+    }
+
+    size_t deallocated_count() const {
+        return state_->total_deallocated_.load();
+    }
+
+    size_t current_usage() const {
+        return allocated_count() - deallocated_count();
+    }
+
+    // Blocks ever carved from chunks (free + in use)
+    size_t capacity() const {
+        return static_cast<size_t>(std::min(state_->next_fresh_.load(), max_blocks));
+    }
+
+    // Identifies the state group; equal allocators can free each other's blocks
+    const void* pool_id() const {
+        return state_.group().get();
+    }
+
+private:
+    static constexpr uint64_t pack(uint64_t tag, uint32_t index) {
+        return (tag << 32) | index;
+    }
+    static constexpr uint32_t index_of(uint64_t head) {
+        return static_cast<uint32_t>(head);
+    }
+    static constexpr uint64_t tag_of(uint64_t head) {
+        return head >> 32;
+    }
+
+    static std::atomic_ref<uint32_t> next_of(Block* block) {
+        return std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t*>(block->storage));
+    }
+
+    // 0-based block number -> (chunk, offset); chunk c starts at ChunkBlocks * (2^c - 1)
+    static constexpr std::pair<size_t, size_t> locate(uint64_t i) {
+        size_t chunk = std::bit_width(i / ChunkBlocks + 1) - 1;
+        size_t offset = i - ChunkBlocks * ((uint64_t{1} << chunk) - 1);
+        return {chunk, offset};
+    }
+
+    // index is 1-based; 0 is the empty-list sentinel
+    Block* block_at(uint32_t index) const {
+        auto [chunk, offset] = locate(index - 1);
+        return state_->chunks_[chunk].load(std::memory_order_acquire) + offset;
+    }
+
+    // nullptr for an index that can't be a block of this pool (read from a reused block)
+    Block* try_block_at(uint32_t index) const {
+        uint64_t carved = std::min(state_->next_fresh_.load(std::memory_order_relaxed), max_blocks);
+        if (index - 1 >= carved) {
+            return nullptr;
+        }
+        auto [chunk, offset] = locate(index - 1);
+        Block* base = state_->chunks_[chunk].load(std::memory_order_acquire);
+        return base ? base + offset : nullptr;
+    }
+
+    uint32_t index_for(Block* block) const {
+        for (size_t c = 0; c < max_chunks; ++c) {
+            Block* chunk = state_->chunks_[c].load(std::memory_order_acquire);
+            if (!chunk) {
+                break;
+            }
+            size_t blocks = ChunkBlocks << c;
+            if (block >= chunk && block < chunk + blocks) {
+                return static_cast<uint32_t>(ChunkBlocks * ((size_t{1} << c) - 1) +
+                                             (block - chunk) + 1);
+            }
+        }
+        assert(false && "pointer does not belong to this pool");
+        return 0;
+    }
+
+    // Link ptrs into a chain and push it onto the free list with one CAS (no stats)
+    void push_chain(std::span<T* const> ptrs) {
+        if (ptrs.empty()) {
+            return;
+        }
+
+        uint32_t first = index_for(reinterpret_cast<Block*>(ptrs.front()));
+        for (size_t i = 0; i + 1 < ptrs.size(); i++) {
+            next_of(reinterpret_cast<Block*>(ptrs[i]))
+                .store(index_for(reinterpret_cast<Block*>(ptrs[i + 1])), std::memory_order_relaxed);
+        }
+
+        Block* last = reinterpret_cast<Block*>(ptrs.back());
+        uint64_t head = state_->head_.load(std::memory_order_relaxed);
+        do {
+            next_of(last).store(index_of(head), std::memory_order_relaxed);
+        } while (!state_->head_.compare_exchange_weak(head, pack(tag_of(head) + 1, first),
+                                                      std::memory_order_release,
+                                                      std::memory_order_relaxed));
+    }
+
+    Block* fresh_block() {
+        uint64_t i = state_->next_fresh_.fetch_add(1, std::memory_order_relaxed);
+        if (i >= max_blocks) {
+            throw std::bad_alloc();
+        }
+
+        auto [chunk_index, offset] = locate(i);
+        return chunk_at(chunk_index) + offset;
+    }
+
+    // Claims out.size() consecutive never-used blocks at once
+    void fresh_blocks(std::span<T*> out) {
+        if (out.empty()) {
+            return;
+        }
+        uint64_t first = state_->next_fresh_.fetch_add(out.size(), std::memory_order_relaxed);
+        if (first + out.size() > max_blocks) {
+            throw std::bad_alloc();
+        }
+
+        size_t filled = 0;
+        try {
+            for (; filled < out.size(); filled++) {
+                auto [chunk_index, offset] = locate(first + filled);
+                out[filled] = reinterpret_cast<T*>(chunk_at(chunk_index) + offset);
+            }
+        } catch (...) {
+            push_chain(out.first(filled));  // Carved before a chunk allocation failed
+            throw;
+        }
+    }
+
+    Block* chunk_at(size_t chunk_index) {
+        std::atomic<Block*>& slot = state_->chunks_[chunk_index];
+        Block* chunk = slot.load(std::memory_order_acquire);
+        if (!chunk) {
+            Block* fresh = new Block[ChunkBlocks << chunk_index];
+            if (slot.compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+                chunk = fresh;
+            } else {
+                delete[] fresh;  // Another thread installed this chunk first
+            }
+        }
+        return chunk;
+    }
+};
+
+template <typename T, typename U, size_t ChunkBlocks>
+bool operator==(const LockFreePoolAllocator<T, ChunkBlocks>& a,
+                const LockFreePoolAllocator<U, ChunkBlocks>& b) noexcept {
+    return a.pool_id() == b.pool_id();
+}
+
+template <typename T, typename U, size_t ChunkBlocks>
+bool operator!=(const LockFreePoolAllocator<T, ChunkBlocks>& a,
+                const LockFreePoolAllocator<U, ChunkBlocks>& b) noexcept {
+    return !(a == b);
+}
+
+// =============================================================================
+// Exercise 6: 🌟 Expert - Polymorphic Allocator (std::pmr) Adapters
+// =============================================================================
+
+/*
+ * GOAL: Expose Arena and the size-class pool as std::pmr::memory_resource
+ *
+ * One resource can then back std::pmr::vector, std::pmr::string, std::pmr::unordered_map,
+ * ... without templating every container on an allocator type.
+ */
+
+// Non-owning view of an arena, like ArenaAllocator. Containers share the resource, so it
+// can't tell which epoch a pointer is from: top allocations are only reclaimed until the
+// arena's first reset()/rewind() after the resource was made.
+template <typename ArenaType = Arena>
+class ArenaResource : public std::pmr::memory_resource {
+private:
+    ArenaType* arena_;
+    uint64_t epoch_;
+
+public:
+    explicit ArenaResource(ArenaType& arena) noexcept : arena_(&arena), epoch_(arena.epoch()) {}
+
+    ArenaType& arena() const noexcept {
+        return *arena_;
+    }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return arena_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t) override {
+        arena_->deallocate(ptr, bytes, epoch_);  // Only the top allocation is reclaimed
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        auto* that = dynamic_cast<const ArenaResource*>(&other);
+        return that && that->arena_ == arena_;
+    }
+};
+
+// Lock type for resources that are only used from one thread
+struct NullMutex {
+    void lock() {}
+    void unlock() {}
+};
+
+// SmallObjectPool behind a memory_resource; Mutex = std::mutex makes it thread-safe
+template <typename Mutex = NullMutex>
+class BasicSmallObjectResource : public std::pmr::memory_resource {
+private:
+    std::shared_ptr<SmallObjectPool> pool_;
+    Mutex mutex_;
+
+public:
+    BasicSmallObjectResource() : pool_(std::make_shared<SmallObjectPool>()) {}
+
+    explicit BasicSmallObjectResource(std::shared_ptr<SmallObjectPool> pool)
+        : pool_(std::move(pool)) {}
+
+    const std::shared_ptr<SmallObjectPool>& pool() const noexcept {
+        return pool_;
+    }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        std::lock_guard<Mutex> lock(mutex_);
+        return pool_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        std::lock_guard<Mutex> lock(mutex_);
+        pool_->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        auto* that = dynamic_cast<const BasicSmallObjectResource*>(&other);
+        return that && that->pool_ == pool_;
+    }
+};
+
+using SmallObjectResource = BasicSmallObjectResource<>;
+using SynchronizedSmallObjectResource = BasicSmallObjectResource<std::mutex>;
+
+// =============================================================================
+// Exercise 7: 🌟 Compacting Handle Pool (defragmentation)
+// =============================================================================
+
+/*
+ * GOAL: Undo the scatter a pool's free list accumulates after long churn
+ *
+ * Objects are reached through PoolHandles (slot index + generation) instead of pointers, so
+ * the pool is free to move them. compact() moves every live object, in handle order, into
+ * freshly packed chunks and frees the old ones: iteration is sequential again and handle
+ * order matches address order. Stale handles (destroyed objects) resolve to nullptr.
+ *
+ * Relocator::relocate(from, to) moves one object (default: memcpy for trivially copyable
+ * types, otherwise move-construct + destroy). A relocation hook set on the pool is called
+ * after every move, for fixing up anything that caches raw pointers. Not thread-safe.
+ */
+
+struct PoolHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const PoolHandle&) const = default;
+};
+
+template <typename T>
+struct DefaultRelocator {
+    static void relocate(T* from, T* to) noexcept {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), sizeof(T));
+        } else {
+            static_assert(std::is_nothrow_move_constructible_v<T>,
+                          "relocation must not throw halfway through compact()");
+            ::new (static_cast<void*>(to)) T(std::move(*from));
+            from->~T();
+        }
+    }
+};
+
+template <typename T, size_t ChunkObjects = 1024, typename Relocator = DefaultRelocator<T>>
+class CompactingPool {
+    static_assert(std::has_single_bit(ChunkObjects), "ChunkObjects must be a power of two");
+
+public:
+    // Called after each move; `from` no longer holds an object, it is only for lookups
+    using RelocationHook = std::function<void(PoolHandle, T* from, T* to)>;
+
+private:
+    struct alignas(T) Storage {
+        unsigned char bytes[sizeof(T)];
+    };
+
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    struct HandleSlot {
+        uint32_t position = npos;  // npos while the handle is free
+        uint32_t generation = 0;
+    };
+
+    std::vector<std::unique_ptr<Storage[]>> chunks_;
+    std::vector<uint32_t> owner_;           // Position -> handle index, npos if free
+    std::vector<uint32_t> free_positions_;  // Stack; lowest position on top after growth
+    std::vector<HandleSlot> handles_;
+    std::vector<uint32_t> free_handles_;
+    RelocationHook hook_;
+    size_t live_ = 0;
+    size_t compactions_ = 0;
+
+public:
+    CompactingPool() = default;
+
+    ~CompactingPool() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t pos = 0; pos < owner_.size(); pos++) {
+                if (owner_[pos] != npos) {
+                    at(pos)->~T();
+                }
+            }
+        }
+        std::cout << "🗜️ CompactingPool destroyed (" << live_ << " live, " << compactions_
+                  << " compactions)\n";
+    }
+
+    CompactingPool(const CompactingPool&) = delete;
+    CompactingPool& operator=(const CompactingPool&) = delete;
+
+    template <typename... Args>
+    PoolHandle create(Args&&... args) {
+        if (free_positions_.empty()) {
+            grow();
+        }
+        uint32_t pos = free_positions_.back();
+        ::new (static_cast<void*>(at(pos))) T(std::forward<Args>(args)...);
+        free_positions_.pop_back();
+
+        uint32_t index;
+        if (free_handles_.empty()) {
+            index = static_cast<uint32_t>(handles_.size());
+            handles_.emplace_back();
+        } else {
+            index = free_handles_.back();
+            free_handles_.pop_back();
+        }
+        handles_[index].position = pos;
+        owner_[pos] = index;
+        live_++;
+        return {index, handles_[index].generation};
+    }
+
+    // Stale or already destroyed handles are ignored
+    void destroy(PoolHandle handle) {
+        T* object = get(handle);
+        if (!object) {
+            return;
+        }
+        HandleSlot& slot = handles_[handle.index];
+        object->~T();
+        owner_[slot.position] = npos;
+        free_positions_.push_back(slot.position);
+        slot.position = npos;
+        slot.generation++;
+        free_handles_.push_back(handle.index);
+        live_--;
+    }
+
+    T* get(PoolHandle handle) {
+        if (handle.index >= handles_.size()) {
+            return nullptr;
+        }
+        const HandleSlot& slot = handles_[handle.index];
+        if (slot.generation != handle.generation || slot.position == npos) {
+            return nullptr;
+        }
+        return at(slot.position);
+    }
+
+    const T* get(PoolHandle handle) const {
+        return const_cast<CompactingPool*>(this)->get(handle);
+    }
+
+    // Live objects in address order (handle order right after compact())
+    template <typename Fn>
+    void for_each(Fn&& fn) {
+        for (size_t pos = 0; pos < owner_.size(); pos++) {
+            if (owner_[pos] != npos) {
+                fn(*at(pos));
+            }
+        }
+    }
+
+    void set_relocation_hook(RelocationHook hook) {
+        hook_ = std::move(hook);
+    }
+
+    // Move every live object, in handle order, into as few fresh chunks as possible and
+    // free the old ones. Returns the number of objects moved.
+    size_t compact() {
+        std::vector<std::unique_ptr<Storage[]>> dense((live_ + ChunkObjects - 1) / ChunkObjects);
+        for (auto& chunk : dense) {
+            chunk = std::make_unique<Storage[]>(ChunkObjects);
+        }
+        std::vector<uint32_t> owner(dense.size() * ChunkObjects, npos);
+
+        uint32_t next = 0;
+        for (uint32_t index = 0; index < handles_.size(); index++) {
+            HandleSlot& slot = handles_[index];
+            if (slot.position == npos) {
+                continue;
+            }
+            T* from = at(slot.position);
+            T* to = reinterpret_cast<T*>(&dense[next / ChunkObjects][next % ChunkObjects]);
+            Relocator::relocate(from, to);
+            if (hook_) {
+                hook_({index, slot.generation}, from, to);
+            }
+            slot.position = next;
+            owner[next] = index;
+            next++;
+        }
+
+        chunks_ = std::move(dense);
+        owner_ = std::move(owner);
+        free_positions_.clear();
+        for (size_t pos = owner_.size(); pos > live_; pos--) {
+            free_positions_.push_back(static_cast<uint32_t>(pos - 1));
+        }
+        compactions_++;
+        return live_;
+    }
+
+    size_t size() const {
+        return live_;
+    }
+
+    size_t capacity() const {
+        return owner_.size();
+    }
+
+    size_t chunk_count() const {
+        return chunks_.size();
+    }
+
+    // Share of the positions up to the last live object that are holes (0 = fully packed)
+    double fragmentation() const {
+        size_t end = owner_.size();
+        while (end > 0 && owner_[end - 1] == npos) {
+            end--;
+        }
+        return end == 0 ? 0.0 : 1.0 - static_cast<double>(live_) / static_cast<double>(end);
+    }
+
+private:
+    T* at(size_t pos) {
+        return reinterpret_cast<T*>(&chunks_[pos / ChunkObjects][pos % ChunkObjects]);
+    }
+
+    void grow() {
+        size_t first = owner_.size();
+        if (first + ChunkObjects > npos) {
+            throw std::bad_alloc();
+        }
+        chunks_.push_back(std::make_unique<Storage[]>(ChunkObjects));
+        owner_.resize(first + ChunkObjects, npos);
+        for (size_t pos = first + ChunkObjects; pos > first; pos--) {
+            free_positions_.push_back(static_cast<uint32_t>(pos - 1));
+        }
+    }
+};
+
+// =============================================================================
+// Exercise 8: 🌟 Slot Map (dense storage, generational handles)
+// =============================================================================
+
+/*
+ * GOAL: Entity storage without pointer chasing
+ *
+ * Live objects sit packed in one vector, so iteration is a linear scan. Callers hold
+ * SlotHandles (32-bit slot index + 32-bit generation) that stay valid however the storage
+ * moves:
+ * - create() takes a slot from the free list and appends the object: O(1)
+ * - destroy() moves the last object into the hole and repoints its slot: O(1), order not kept
+ * - get() checks the handle's generation against its slot and only then touches the
+ *   object, so a stale handle is caught without reading freed or reused storage
+ *
+ * A slot's generation is odd while it is live and even while it is free, so a handle can
+ * never match a free slot. A slot whose generation would wrap is retired instead of reused.
+ * Pointers returned by get() and values() are invalidated by create() and destroy().
+ * Not thread-safe.
+ */
+
+// Same layout as PoolHandle but a distinct type, so a CompactingPool handle can't be passed
+// to a SlotMap or the other way round
+struct SlotHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const SlotHandle&) const = default;
+};
+
+template <typename T>
+class SlotMap {
+private:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    struct Slot {
+        uint32_t position = npos;  // Live: index into values_. Free: next free slot.
+        uint32_t generation = 0;   // Odd while live
+    };
+
+    std::vector<T> values_;         // Live objects, packed
+    std::vector<uint32_t> owners_;  // values_[i] belongs to slot owners_[i]
+    std::vector<Slot> slots_;
+    uint32_t free_head_ = npos;
+    size_t retired_ = 0;
+
+public:
+    SlotMap() = default;
+
+    void reserve(size_t n) {
+        values_.reserve(n);
+        owners_.reserve(n);
+        slots_.reserve(n);
+    }
+
+    template <typename... Args>
+    SlotHandle create(Args&&... args) {
+        uint32_t index = free_head_;
+        bool fresh = index == npos;
+        if (fresh) {
+            if (slots_.size() >= npos) {
+                throw std::bad_alloc();
+            }
+            index = static_cast<uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+
+        // Nothing is handed out until T is built: if that throws, a reused slot is still
+        // at the head of the free list and a fresh one is dropped again
+        try {
+            owners_.push_back(index);
+            values_.emplace_back(std::forward<Args>(args)...);
+        } catch (...) {
+            owners_.resize(values_.size());  // Drops the owner entry if it was pushed
+            if (fresh) {
+                slots_.pop_back();
+            }
+            throw;
+        }
+
+        Slot& slot = slots_[index];
+        if (index == free_head_) {
+            free_head_ = slot.position;
+        }
+        slot.position = static_cast<uint32_t>(values_.size() - 1);
+        slot.generation++;
+        return {index, slot.generation};
+    }
+
+    // Returns false (and does nothing) for stale or unknown handles
+    bool destroy(SlotHandle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+        Slot& slot = slots_[handle.index];
+        uint32_t hole = slot.position;
+        uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+        if (hole != last) {
+            values_[hole] = std::move(values_[last]);
+            owners_[hole] = owners_[last];
+            slots_[owners_[hole]].position = hole;
+        }
+        values_.pop_back();
+        owners_.pop_back();
+
+        slot.generation++;
+        if (slot.generation == 0) {
+            retired_++;  // Wrapped: reusing it could revive handles from 2^31 lives ago
+        } else {
+            slot.position = free_head_;
+            free_head_ = handle.index;
+        }
+        return true;
+    }
+
+    bool contains(SlotHandle handle) const {
+        return (handle.generation & 1) != 0 && handle.index < slots_.size() &&
+               slots_[handle.index].generation == handle.generation;
+    }
+
+    T* get(SlotHandle handle) {
+        return contains(handle) ? &values_[slots_[handle.index].position] : nullptr;
+    }
+
+    const T* get(SlotHandle handle) const {
+        return contains(handle) ? &values_[slots_[handle.index].position] : nullptr;
+    }
+
+    // The live objects, packed; values()[i] is reached through handle_at(i)
+    std::span<T> values() {
+        return values_;
+    }
+
+    std::span<const T> values() const {
+        return values_;
+    }
+
+    SlotHandle handle_at(size_t position) const {
+        uint32_t index = owners_[position];
+        return {index, slots_[index].generation};
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) {
+        for (T& value : values_) {
+            fn(value);
+        }
+    }
+
+    // Destroys everything; every outstanding handle goes stale
+    void clear() {
+        while (!values_.empty()) {
+            destroy(handle_at(values_.size() - 1));
+        }
+    }
+
+    size_t size() const {
+        return values_.size();
+    }
+
+    bool empty() const {
+        return values_.empty();
+    }
+
+    // Slots ever handed out (live + free + retired)
+    size_t slot_count() const {
+        return slots_.size();
+    }
+
+    size_t retired_slots() const {
+        return retired_;
+    }
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+/*
+ * Checked mode for the pools and arenas: red-zone canaries, poison-on-free and double-free
+ * detection
+ *
+ * Pools and arenas never hand memory back to malloc, so AddressSanitizer can't see a
+ * use-after-free or an overflow into a neighbouring block. In checked mode:
+ * - every block/allocation is followed by a red zone of canary bytes, verified when it is
+ *   freed (and, for arenas, on rewind/reset)
+ * - freed memory is filled with a pattern and, under ASan, poisoned; the unused tail of
+ *   an arena block stays poisoned too, so stray accesses fault at once
+ * - a pool block's header records whether it is live, so freeing it twice is reported
+ *
+ * Opt in per pool (PoolGuardMode::checked) or arena (CheckedArena), or for everything by
+ * default with -DIMPSTUDY_ALLOCATOR_GUARDS=1 (CMake: -DALLOCATOR_GUARDS=ON).
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if __has_include(<sanitizer/asan_interface.h>)
+#include <sanitizer/asan_interface.h>
+#endif
+
+// asan_interface.h turns these into no-ops when ASan is off; cover compilers without it
+#ifndef ASAN_POISON_MEMORY_REGION
+#define ASAN_POISON_MEMORY_REGION(addr, size) ((void)(addr), (void)(size))
+#define ASAN_UNPOISON_MEMORY_REGION(addr, size) ((void)(addr), (void)(size))
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define IMPSTUDY_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define IMPSTUDY_ASAN 1
+#endif
+#endif
+#ifndef IMPSTUDY_ASAN
+#define IMPSTUDY_ASAN 0
+#endif
+
+#ifndef IMPSTUDY_ALLOCATOR_GUARDS
+#define IMPSTUDY_ALLOCATOR_GUARDS 0
+#endif
+
+class AllocatorGuards {
+public:
+    static constexpr bool enabled_by_default = IMPSTUDY_ALLOCATOR_GUARDS != 0;
+
+    static constexpr size_t red_zone = 16;
+    static constexpr unsigned char canary = 0xFD;  // Red zones
+    static constexpr unsigned char freed = 0xDD;   // Poison-on-free
+
+    // Called with a description and the user pointer involved. The default prints and
+    // aborts; if a handler returns, the allocator skips the offending operation.
+    using Handler = void (*)(const char* what, const void* ptr);
+
+    static Handler set_handler(Handler handler) {
+        return handler_.exchange(handler ? handler : &abort_handler);
+    }
+
+    static void report(const char* what, const void* ptr) {
+        handler_.load()(what, ptr);
+    }
+
+    // Whether [ptr, ptr + n) still holds nothing but `pattern` (caller unpoisons first)
+    static bool intact(const void* ptr, size_t n, unsigned char pattern) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(ptr);
+        for (size_t i = 0; i < n; i++) {
+            if (bytes[i] != pattern) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void poison(const void* ptr, size_t n) {
+        ASAN_POISON_MEMORY_REGION(ptr, n);
+    }
+
+    static void unpoison(const void* ptr, size_t n) {
+        ASAN_UNPOISON_MEMORY_REGION(ptr, n);
+    }
+
+    // Always false without ASan
+    static bool is_poisoned(const void* ptr) {
+#if IMPSTUDY_ASAN
+        return __asan_address_is_poisoned(ptr) != 0;
+#else
+        return false;
+#endif
+    }
+
+private:
+    [[noreturn]] static void abort_handler(const char* what, const void* ptr) {
+        std::cerr << "💥 Allocator guard: " << what << " at " << ptr << "\n";
+        std::abort();
+    }
+
+    static inline std::atomic<Handler> handler_{&abort_handler};
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+/*
+ * NUMA topology for node-aware allocators (Linux syscalls, no libnuma dependency)
+ *
+ * node_count()    nodes listed in /sys/devices/system/node/online (1 if unknown)
+ * current_node()  node of the CPU the calling thread runs on (getcpu), cached per thread
+ * prefer_node()   mbind(MPOL_PREFERRED) a page-aligned range so its pages land on a node
+ * resident_node() get_mempolicy(MPOL_F_NODE | MPOL_F_ADDR): the node a touched page is on
+ *
+ * set_fake_nodes(n) pretends the machine has n nodes: threads get nodes round-robin on
+ * first use and prefer_node() does nothing, so node-aware code can be exercised on a
+ * single-socket machine.
+ *
+ * current_node() is looked up once per thread, like libnuma's numa_node_of_cpu() at thread
+ * start: a thread the scheduler later moves to another node keeps its old answer. Pin
+ * threads (taskset, numactl --cpunodebind) when placement matters.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__) && __has_include(<sys/syscall.h>) && __has_include(<unistd.h>)
+#define IMPSTUDY_HAS_NUMA_SYSCALLS 1
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#define IMPSTUDY_HAS_NUMA_SYSCALLS 0
+#endif
+
+class NumaTopology {
+public:
+    static size_t node_count() {
+        size_t fake = fake_nodes_.load(std::memory_order_relaxed);
+        return fake ? fake : real_node_count();
+    }
+
+    static bool is_fake() {
+        return fake_nodes_.load(std::memory_order_relaxed) != 0;
+    }
+
+    // 0 goes back to the real topology. Threads pick the change up on their next
+    // current_node(); allocators keep the node count they were created with.
+    static void set_fake_nodes(size_t nodes) {
+        fake_nodes_.store(nodes, std::memory_order_relaxed);
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+
+    static size_t current_node() {
+        thread_local uint64_t cached_generation = ~uint64_t{0};
+        thread_local size_t cached_node = 0;
+
+        uint64_t generation = generation_.load(std::memory_order_acquire);
+        if (generation != cached_generation) {
+            cached_node = lookup_node();
+            cached_generation = generation;
+        }
+        return cached_node;
+    }
+
+    // Best effort: ignored in fake mode, on single-node machines and for ranges that
+    // aren't whole pages. Call before the memory is first touched, or pages already
+    // faulted elsewhere have to be migrated (MPOL_MF_MOVE).
+    static void prefer_node(void* ptr, size_t bytes, size_t node) noexcept {
+#if IMPSTUDY_HAS_NUMA_SYSCALLS && defined(SYS_mbind)
+        constexpr int mpol_preferred = 1;  // <linux/mempolicy.h>
+        constexpr unsigned mpol_mf_move = 1u << 1;
+
+        if (is_fake() || real_node_count() < 2 || node >= 64) {
+            return;
+        }
+        if (reinterpret_cast<uintptr_t>(ptr) % page_size() != 0 || bytes % page_size() != 0) {
+            return;
+        }
+        unsigned long mask = 1ul << node;
+        syscall(SYS_mbind, ptr, bytes, mpol_preferred, &mask, sizeof(mask) * 8, mpol_mf_move);
+#endif
+    }
+
+    // Real node holding the (already touched) page at ptr; nullopt in fake mode or where the
+    // kernel can't tell. Checks that prefer_node() placements actually happened.
+    static std::optional<size_t> resident_node(const void* ptr) noexcept {
+#if IMPSTUDY_HAS_NUMA_SYSCALLS && defined(SYS_get_mempolicy)
+        constexpr unsigned long mpol_f_node = 1ul << 0;
+        constexpr unsigned long mpol_f_addr = 1ul << 1;
+
+        int node = -1;
+        if (!is_fake() && syscall(SYS_get_mempolicy, &node, nullptr, 0ul, ptr,
+                                  mpol_f_node | mpol_f_addr) == 0 && node >= 0) {
+            return static_cast<size_t>(node);
+        }
+#endif
+        return std::nullopt;
+    }
+
+    // Granularity of prefer_node(): callers size and align node-local slabs to it
+    static size_t page_size() noexcept {
+#if IMPSTUDY_HAS_NUMA_SYSCALLS
+        static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+#else
+        return 4096;
+#endif
+    }
+
+private:
+    static size_t real_node_count() {
+        static const size_t count = read_online_nodes();
+        return count;
+    }
+
+    // "0", "0-3" or "0-1,4-5": the highest listed node + 1
+    static size_t read_online_nodes() {
+        std::ifstream file("/sys/devices/system/node/online");
+        std::string list;
+        if (!(file >> list)) {
+            return 1;
+        }
+
+        size_t highest = 0;
+        std::stringstream ranges(list);
+        std::string range;
+        while (std::getline(ranges, range, ',')) {
+            size_t dash = range.find('-');
+            std::string last = dash == std::string::npos ? range : range.substr(dash + 1);
+            if (!last.empty()) {
+                highest = std::max(highest, static_cast<size_t>(std::stoul(last)));
+            }
+        }
+        return highest + 1;
+    }
+
+    static size_t lookup_node() {
+        size_t fake = fake_nodes_.load(std::memory_order_relaxed);
+        if (fake) {
+            static std::atomic<size_t> next{0};
+            return next.fetch_add(1, std::memory_order_relaxed) % fake;
+        }
+
+#if IMPSTUDY_HAS_NUMA_SYSCALLS && defined(SYS_getcpu)
+        unsigned cpu = 0;
+        unsigned node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+            return std::min<size_t>(node, real_node_count() - 1);
+        }
+#endif
+        return 0;
+    }
+
+    static inline std::atomic<size_t> fake_nodes_{0};
+    static inline std::atomic<uint64_t> generation_{0};
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+/*
+ * Backing-page providers for pools and arenas
+ *
+ * FixedBlockPool (and so PoolResource/PoolAllocator) and BasicArena get their chunks from a
+ * PageProvider. The default, PageProvider::heap(), is plain ::operator new. MmapPageProvider
+ * maps anonymous memory directly, which allows:
+ * - MAP_HUGETLB pages (needs pages reserved in /proc/sys/vm/nr_hugepages), falling back to
+ * - transparent huge pages via madvise(MADV_HUGEPAGE) on 2 MB-aligned mappings
+ * - pre-faulting (MAP_POPULATE) so the first pass over a fresh arena doesn't page-fault
+ * - release_pages(): MADV_DONTNEED, giving the memory back while keeping the address range
+ *
+ * Providers are not owned by the pools/arenas using them and must outlive them.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <new>
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#define IMPSTUDY_HAS_MMAN 1
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#define IMPSTUDY_HAS_MMAN 0
+#endif
+
+class PageProvider {
+public:
+    virtual ~PageProvider() = default;
+
+    // bytes is a multiple of granularity(); alignment is a power of two
+    virtual void* allocate_pages(size_t bytes, size_t alignment) = 0;
+    virtual void deallocate_pages(void* ptr, size_t bytes, size_t alignment) noexcept = 0;
+
+    // Return the physical memory behind [ptr, ptr + bytes) to the OS but keep the range
+    // usable. Its contents are lost. Providers that can't do this ignore the call.
+    virtual void release_pages(void* ptr, size_t bytes) noexcept {}
+
+    // Callers round their chunk sizes up to this so no part of a page is wasted
+    virtual size_t granularity() const noexcept {
+        return 1;
+    }
+
+    static size_t round_up(size_t bytes, size_t granularity) noexcept {
+        return (bytes + granularity - 1) / granularity * granularity;
+    }
+
+    // ::operator new / ::operator delete
+    static PageProvider& heap();
+};
+
+class HeapPageProvider final : public PageProvider {
+public:
+    void* allocate_pages(size_t bytes, size_t alignment) override {
+        return ::operator new(bytes, std::align_val_t{alignment});
+    }
+
+    void deallocate_pages(void* ptr, size_t bytes, size_t alignment) noexcept override {
+        ::operator delete(ptr, std::align_val_t{alignment});
+    }
+};
+
+inline PageProvider& PageProvider::heap() {
+    static HeapPageProvider instance;
+    return instance;
+}
+
+#if IMPSTUDY_HAS_MMAN
+
+struct MmapPageOptions {
+    bool huge_pages = false;             // MAP_HUGETLB; falls back to THP if none are reserved
+    bool transparent_huge_pages = true;  // madvise(MADV_HUGEPAGE) mappings of >= 2 MB
+    bool populate = false;               // Pre-fault every page when mapping
+};
+
+class MmapPageProvider final : public PageProvider {
+public:
+    static constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+    explicit MmapPageProvider(MmapPageOptions options = {})
+        : options_(options), page_size_(static_cast<size_t>(sysconf(_SC_PAGESIZE))) {}
+
+    ~MmapPageProvider() override {
+        if (mapped_bytes_.load() != 0) {
+            std::cout << "⚠️  MmapPageProvider destroyed with " << mapped_bytes_.load()
+                      << " bytes still mapped\n";
+        }
+    }
+
+    MmapPageProvider(const MmapPageProvider&) = delete;
+    MmapPageProvider& operator=(const MmapPageProvider&) = delete;
+
+    void* allocate_pages(size_t bytes, size_t alignment) override {
+        size_t length = round_up(bytes, granularity());
+
+        if (options_.huge_pages) {
+            // Chunk pools mask addresses with their chunk size, so a chunk larger than a huge
+            // page needs the alignment honoured here too; the trim stays on huge-page bounds
+            void* ptr = map_aligned(length, std::max(alignment, huge_page_size),
+                                    MAP_HUGETLB | (options_.populate ? MAP_POPULATE : 0),
+                                    huge_page_size);
+            if (ptr) {
+                hugetlb_bytes_.fetch_add(length, std::memory_order_relaxed);
+                return account(ptr, length);
+            }
+            hugetlb_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // A 2 MB-aligned mapping can be backed by huge pages from its first fault on
+        bool thp = options_.transparent_huge_pages && length >= huge_page_size;
+        size_t align = std::max({alignment, page_size_, thp ? huge_page_size : size_t{0}});
+
+        // MAP_POPULATE would fault 4K pages before madvise() gets a say, so THP pre-faults
+        // by touching the pages afterwards instead
+        int flags = options_.populate && !thp ? MAP_POPULATE : 0;
+        char* ptr = static_cast<char*>(map_aligned(length, align, flags, page_size_));
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+
+        if (thp) {
+            madvise(ptr, length, MADV_HUGEPAGE);
+            if (options_.populate) {
+                for (size_t offset = 0; offset < length; offset += page_size_) {
+                    ptr[offset] = 0;
+                }
+            }
+        }
+        return account(ptr, length);
+    }
+
+    void deallocate_pages(void* ptr, size_t bytes, size_t alignment) noexcept override {
+        size_t length = round_up(bytes, granularity());
+        munmap(ptr, length);
+        mapped_bytes_.fetch_sub(length, std::memory_order_relaxed);
+    }
+
+    // Only whole pages inside the range are released
+    void release_pages(void* ptr, size_t bytes) noexcept override {
+        uintptr_t begin = reinterpret_cast<uintptr_t>(ptr);
+        uintptr_t first = round_up(begin, granularity());
+        uintptr_t last = (begin + bytes) / granularity() * granularity();
+        if (first < last) {
+            madvise(reinterpret_cast<void*>(first), last - first, MADV_DONTNEED);
+            released_bytes_.fetch_add(last - first, std::memory_order_relaxed);
+        }
+    }
+
+    // HugeTLB mappings must be whole huge pages; use the same size for the fallback so
+    // deallocate_pages() unmaps the right length either way
+    size_t granularity() const noexcept override {
+        return options_.huge_pages ? huge_page_size : page_size_;
+    }
+
+    size_t mapped_bytes() const noexcept {
+        return mapped_bytes_.load(std::memory_order_relaxed);
+    }
+
+    size_t hugetlb_bytes() const noexcept {
+        return hugetlb_bytes_.load(std::memory_order_relaxed);
+    }
+
+    size_t hugetlb_fallbacks() const noexcept {
+        return hugetlb_fallbacks_.load(std::memory_order_relaxed);
+    }
+
+    size_t released_bytes() const noexcept {
+        return released_bytes_.load(std::memory_order_relaxed);
+    }
+
+    void print_stats() const {
+        std::cout << "🗺️ MmapPageProvider: " << mapped_bytes() << " bytes mapped, "
+                  << hugetlb_bytes() << " via MAP_HUGETLB (" << hugetlb_fallbacks()
+                  << " fallbacks), " << released_bytes() << " bytes released\n";
+    }
+
+private:
+    static void* map(size_t length, int extra_flags) {
+        void* ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    // Over-map by `align` and unmap the misaligned head and the tail. `page` is the size the
+    // mapping is naturally aligned to (and can be split at): the base or the huge page size.
+    static void* map_aligned(size_t length, size_t align, int extra_flags, size_t page) {
+        size_t slack = align > page ? align : 0;
+        char* raw = static_cast<char*>(map(length + slack, extra_flags));
+        if (!raw) {
+            return nullptr;
+        }
+
+        char* ptr = reinterpret_cast<char*>(round_up(reinterpret_cast<uintptr_t>(raw), align));
+        if (ptr != raw) {
+            munmap(raw, ptr - raw);
+        }
+        size_t tail = (raw + length + slack) - (ptr + length);
+        if (tail != 0) {
+            munmap(ptr + length, tail);
+        }
+        return ptr;
+    }
+
+    void* account(void* ptr, size_t length) noexcept {
+        mapped_bytes_.fetch_add(length, std::memory_order_relaxed);
+        return ptr;
+    }
+
+    MmapPageOptions options_;
+    size_t page_size_;
+    std::atomic<size_t> mapped_bytes_{0};
+    std::atomic<size_t> hugetlb_bytes_{0};
+    std::atomic<size_t> hugetlb_fallbacks_{0};
+    std::atomic<size_t> released_bytes_{0};
+};
+
+#endif  // IMPSTUDY_HAS_MMAN
@@ -0,0 +1,76 @@
+#pragma once
+
+/*
+ * Hand-vectorised particle update kernels, picked at run time
+ *
+ * x += vx * dt, y += vy * dt, z += vz * dt, life -= dt over ParticleSystem's streams, in four
+ * flavours:
+ * - scalar  plain loop, auto-vectorised only as far as the build's baseline ISA allows
+ * - sse2    4 floats per instruction (the x86-64 baseline)
+ * - avx2    8 floats, FMA
+ * - avx512  16 floats, FMA, masked tail
+ *
+ * Each SIMD kernel lives in its own translation unit built with just the -m flags it needs
+ * (src/CMakeLists.txt), so the rest of the binary stays portable: nothing depends on
+ * -march=native. ParticleKernels::detected() asks CPUID (__builtin_cpu_supports, which also
+ * checks the OS saves the wider registers) once and update() hands out the best kernel.
+ * Setting IMPSTUDY_SIMD=scalar|sse2|avx2|avx512 caps the choice, e.g. to compare levels.
+ *
+ * The AVX2/AVX-512 kernels fuse the multiply-add, so their results can differ from the
+ * scalar and SSE2 ones in the last bit.
+ */
+
+#include <array>
+#include <cstddef>
+
+enum class SimdLevel { scalar, sse2, avx2, avx512 };
+
+// The streams update() touches; every pointer 64-byte aligned
+struct ParticleStreams {
+    float* x;
+    float* y;
+    float* z;
+    const float* vx;
+    const float* vy;
+    const float* vz;
+    float* life;
+    size_t count;
+
+    // Particles [first, last), e.g. one chunk of a parallel update. first must be a multiple
+    // of 16 so the slice stays 64-byte aligned.
+    ParticleStreams slice(size_t first, size_t last) const {
+        return {x + first, y + first, z + first, vx + first, vy + first, vz + first, life + first,
+                last - first};
+    }
+};
+
+using ParticleUpdateKernel = void (*)(const ParticleStreams& streams, float dt);
+
+// One per translation unit; the SIMD ones only exist when IMPSTUDY_SIMD_KERNELS is set
+void update_particles_scalar(const ParticleStreams& streams, float dt);
+void update_particles_sse2(const ParticleStreams& streams, float dt);
+void update_particles_avx2(const ParticleStreams& streams, float dt);
+void update_particles_avx512(const ParticleStreams& streams, float dt);
+
+class ParticleKernels {
+public:
+    static constexpr std::array<SimdLevel, 4> levels = {SimdLevel::scalar, SimdLevel::sse2,
+                                                        SimdLevel::avx2, SimdLevel::avx512};
+
+    // Highest level both the CPU and this build support, capped by IMPSTUDY_SIMD
+    static SimdLevel detected();
+
+    static bool supported(SimdLevel level) {
+        return level <= detected();
+    }
+
+    // The kernel for `level`, which must be supported()
+    static ParticleUpdateKernel update(SimdLevel level);
+
+    static ParticleUpdateKernel update() {
+        static const ParticleUpdateKernel best = update(detected());
+        return best;
+    }
+
+    static const char* name(SimdLevel level);
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+/*
+ * Struct-of-arrays particle storage on an arena
+ *
+ * In an array of `struct Particle { x, y, z, vx, vy, vz, life, color }` the position update
+ * drags color (and the stride of every other field) through the cache, and the fields it
+ * streams are interleaved, so eight x's can't be loaded with one instruction.
+ * ParticleSystem keeps each field in its own array:
+ * - every array is carved from an Arena, 64-byte aligned and padded to whole cache lines
+ * - update() reads and writes only the streams it needs, one contiguous run per field, with
+ *   the widest SIMD kernel the CPU supports (particle_kernels.hpp)
+ *
+ * Capacity is fixed at construction; the arrays live as long as the arena's memory does
+ * (reset() or rewind() past them and the system must not be used again).
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+
+#include "allocators.hpp"
+#include "particle_kernels.hpp"
+
+template <typename ArenaT = Arena>
+class ParticleSystem {
+public:
+    static constexpr size_t alignment = 64;
+
+    // Arena bytes ParticleSystem(arena, capacity) takes, for sizing a fixed arena
+    static size_t bytes_for(size_t capacity) {
+        return stream_count * (padded(capacity) * sizeof(float) + alignment + ArenaT::guard_bytes);
+    }
+
+    ParticleSystem(ArenaT& arena, size_t capacity) : capacity_(padded(capacity)) {
+        x_ = allocate<float>(arena);
+        y_ = allocate<float>(arena);
+        z_ = allocate<float>(arena);
+        vx_ = allocate<float>(arena);
+        vy_ = allocate<float>(arena);
+        vz_ = allocate<float>(arena);
+        life_ = allocate<float>(arena);
+        color_ = allocate<int>(arena);
+    }
+
+    // The arrays belong to the arena
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    size_t size() const {
+        return size_;
+    }
+
+    // At least the requested capacity: rounded up to whole cache lines
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    size_t spawn(float x, float y, float z, float vx, float vy, float vz, float life,
+                 int color) {
+        if (size_ == capacity_) {
+            throw std::length_error("ParticleSystem is full");
+        }
+        size_t i = size_++;
+        x_[i] = x;
+        y_[i] = y;
+        z_[i] = z;
+        vx_[i] = vx;
+        vy_[i] = vy;
+        vz_[i] = vz;
+        life_[i] = life;
+        color_[i] = color;
+        return i;
+    }
+
+    // New particles are zeroed, like vector<Particle>::resize
+    void resize(size_t n) {
+        if (n > capacity_) {
+            throw std::length_error("ParticleSystem is full");
+        }
+        if (n > size_) {
+            for (float* stream : {x_, y_, z_, vx_, vy_, vz_, life_}) {
+                std::fill(stream + size_, stream + n, 0.0f);
+            }
+            std::fill(color_ + size_, color_ + n, 0);
+        }
+        size_ = n;
+    }
+
+    void clear() {
+        size_ = 0;
+    }
+
+    std::span<float> x() {
+        return {x_, size_};
+    }
+
+    std::span<float> y() {
+        return {y_, size_};
+    }
+
+    std::span<float> z() {
+        return {z_, size_};
+    }
+
+    std::span<float> vx() {
+        return {vx_, size_};
+    }
+
+    std::span<float> vy() {
+        return {vy_, size_};
+    }
+
+    std::span<float> vz() {
+        return {vz_, size_};
+    }
+
+    std::span<float> life() {
+        return {life_, size_};
+    }
+
+    std::span<int> color() {
+        return {color_, size_};
+    }
+
+    // Integrate positions and age every particle by dt with the best kernel for this CPU.
+    // Touches 7 of the 8 streams; color is never loaded.
+    void update(float dt) {
+        ParticleKernels::update()(streams(), dt);
+    }
+
+    // A specific kernel; level must be ParticleKernels::supported()
+    void update(float dt, SimdLevel level) {
+        ParticleKernels::update(level)(streams(), dt);
+    }
+
+    ParticleStreams streams() {
+        return {x_, y_, z_, vx_, vy_, vz_, life_, size_};
+    }
+
+    // Swap-removes every particle with life <= 0 (order is not kept). Returns how many died.
+    size_t remove_dead() {
+        size_t before = size_;
+        size_t i = 0;
+        while (i < size_) {
+            if (life_[i] > 0.0f) {
+                i++;
+                continue;
+            }
+            size_t last = --size_;
+            x_[i] = x_[last];
+            y_[i] = y_[last];
+            z_[i] = z_[last];
+            vx_[i] = vx_[last];
+            vy_[i] = vy_[last];
+            vz_[i] = vz_[last];
+            life_[i] = life_[last];
+            color_[i] = color_[last];
+        }
+        return before - size_;
+    }
+
+private:
+    static constexpr size_t stream_count = 8;
+
+    static size_t padded(size_t capacity) {
+        constexpr size_t per_line = alignment / sizeof(float);
+        return (capacity + per_line - 1) / per_line * per_line;
+    }
+
+    template <typename T>
+    T* allocate(ArenaT& arena) {
+        static_assert(sizeof(T) == sizeof(float));
+        return static_cast<T*>(arena.allocate(capacity_ * sizeof(T), alignment));
+    }
+
+    size_t size_ = 0;
+    size_t capacity_;
+    float* x_;
+    float* y_;
+    float* z_;
+    float* vx_;
+    float* vy_;
+    float* vz_;
+    float* life_;
+    int* color_;
+};
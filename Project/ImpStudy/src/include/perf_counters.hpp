@@ -0,0 +1,233 @@
+#pragma once
+
+/*
+ * Hardware performance counters for the benchmarks (Linux perf_event_open)
+ *
+ * Counts cycles, instructions, branch misses, L1D/LLC read misses, dTLB read misses and
+ * page faults for the calling thread, user space only. Every event is opened on its own,
+ * so a VM without a PMU, perf_event_paranoid or a seccomp filter just turns the affected
+ * counters off instead of failing the benchmark. On other platforms nothing is counted.
+ *
+ * Usage:
+ *   PerfCounters perf;
+ *   perf.start();
+ *   ... workload ...
+ *   PerfCounters::Reading reading = perf.stop();
+ *   perf.print_per_op(reading, ops);
+ */
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#define IMPSTUDY_HAS_PERF_EVENTS 1
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#define IMPSTUDY_HAS_PERF_EVENTS 0
+#endif
+
+class PerfCounters {
+public:
+    enum Event : size_t {
+        cycles,
+        instructions,
+        branch_misses,
+        l1d_misses,
+        llc_misses,
+        dtlb_misses,
+        page_faults,
+        num_events
+    };
+
+    // Missing values are counters the kernel refused to open
+    struct Reading {
+        std::array<std::optional<uint64_t>, num_events> values;
+    };
+
+    PerfCounters() {
+        fds_.fill(-1);
+#if IMPSTUDY_HAS_PERF_EVENTS
+        for (size_t i = 0; i < num_events; ++i) {
+            fds_[i] = open_event(static_cast<Event>(i));
+            if (fds_[i] < 0 && error_.empty()) {
+                error_ = std::strerror(errno);
+            }
+        }
+#else
+        error_ = "perf_event_open not supported on this platform";
+#endif
+    }
+
+    ~PerfCounters() {
+#if IMPSTUDY_HAS_PERF_EVENTS
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    static const char* name(Event event) {
+        static constexpr const char* names[num_events] = {
+            "cycles", "instr", "br-miss", "L1D-miss", "LLC-miss", "dTLB-miss", "page-faults"};
+        return names[event];
+    }
+
+    bool available(Event event) const {
+        return fds_[event] >= 0;
+    }
+
+    // True when at least one hardware counter could be opened
+    bool hardware_available() const {
+        for (size_t i = 0; i < page_faults; ++i) {
+            if (fds_[i] >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Why the first counter failed to open (empty if all opened)
+    const std::string& error() const {
+        return error_;
+    }
+
+    void start() {
+#if IMPSTUDY_HAS_PERF_EVENTS
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    Reading stop() {
+        Reading reading;
+#if IMPSTUDY_HAS_PERF_EVENTS
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (size_t i = 0; i < num_events; ++i) {
+            if (fds_[i] < 0) {
+                continue;
+            }
+            // value, time_enabled, time_running (PERF_FORMAT_TOTAL_TIME_*)
+            uint64_t data[3] = {};
+            if (read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+                continue;
+            }
+            if (data[2] == 0) {
+                continue;  // Never got scheduled on the PMU
+            }
+            // Scale up if the PMU had to multiplex this counter with others
+            if (data[2] < data[1]) {
+                data[0] = static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+            }
+            reading.values[i] = data[0];
+        }
+#endif
+        return reading;
+    }
+
+    // One line: each available counter divided by ops, plus IPC
+    void print_per_op(const Reading& reading, double ops, const std::string& indent = "   ") const {
+        std::ios_base::fmtflags flags = std::cout.flags();
+        std::streamsize precision = std::cout.precision();
+
+        std::cout << indent << "per op:";
+        for (size_t i = 0; i < num_events; ++i) {
+            if (reading.values[i]) {
+                std::cout << " " << name(static_cast<Event>(i)) << " " << std::fixed
+                          << std::setprecision(i == cycles || i == instructions ? 1 : 3)
+                          << static_cast<double>(*reading.values[i]) / ops;
+            }
+        }
+        if (reading.values[cycles] && reading.values[instructions] && *reading.values[cycles]) {
+            std::cout << " IPC " << std::setprecision(2)
+                      << static_cast<double>(*reading.values[instructions]) /
+                             static_cast<double>(*reading.values[cycles]);
+        }
+        if (!hardware_available()) {
+            std::cout << " (hardware counters unavailable: " << error_ << ")";
+        }
+        std::cout << "\n";
+
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+    }
+
+private:
+#if IMPSTUDY_HAS_PERF_EVENTS
+    static uint64_t cache_event(uint64_t cache, uint64_t op, uint64_t result) {
+        return cache | (op << 8) | (result << 16);
+    }
+
+    static int open_event(Event event) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;  // Allowed at perf_event_paranoid <= 2
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        switch (event) {
+            case cycles:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case instructions:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case branch_misses:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            case l1d_misses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                          PERF_COUNT_HW_CACHE_RESULT_MISS);
+                break;
+            case llc_misses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cache_event(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ,
+                                          PERF_COUNT_HW_CACHE_RESULT_MISS);
+                break;
+            case dtlb_misses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                          PERF_COUNT_HW_CACHE_RESULT_MISS);
+                break;
+            case page_faults:
+            default:
+                attr.type = PERF_TYPE_SOFTWARE;
+                attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+                break;
+        }
+
+        // This thread, any CPU, no group
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    std::array<int, num_events> fds_;
+    std::string error_;
+};
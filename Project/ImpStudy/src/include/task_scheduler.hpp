@@ -0,0 +1,392 @@
+#pragma once
+
+/*
+ * Work-stealing task scheduler with parallel_for over index ranges
+ *
+ * TaskScheduler(n) runs n workers: n - 1 background threads plus the thread that calls
+ * parallel_for(), which works too instead of blocking. Each worker has its own deque:
+ * - a worker handed a range larger than the grain splits it in half, pushes the upper half
+ *   on the back of its deque and keeps going with the lower half (lazy binary splitting)
+ * - it pops its own deque from the back, newest and smallest piece first (still cache-warm)
+ * - an idle worker steals from the front of a random victim's deque, the oldest and largest
+ *   piece, so one steal moves a lot of work and thieves rarely meet again
+ *
+ * Each deque is a plain mutex + std::deque: the owner's lock is uncontended unless a thief
+ * is taking from it at that moment, and pieces are at least a grain (tens of microseconds)
+ * of work, so a lock-free Chase-Lev deque would save nothing measurable here.
+ *
+ * Chunk size: pass a grain, or a GrainTuner that learns one per loop. Untuned, the calling
+ * thread first runs growing probe chunks itself to estimate the cost of one element.
+ *
+ * Scratch memory: a body taking (first, last, Arena&) gets its worker's arena. Everything
+ * allocated from it is released when the chunk ends (ArenaScope), so no locking and no
+ * frees. Exceptions thrown by a body are rethrown from parallel_for once the loop is done.
+ *
+ * parallel_for may be called from inside a body (nested loops share the workers). Calls
+ * from threads outside the scheduler are serialised.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "allocators.hpp"
+
+// Learns a chunk size for one loop; pass the same tuner to every call of that loop. A chunk
+// should take about target_chunk: long enough to hide the deque traffic and the clock reads
+// around it, short enough that idle workers find something left to steal.
+class GrainTuner {
+public:
+    static constexpr std::chrono::nanoseconds target_chunk{50000};
+
+    bool tuned() const {
+        return ns_per_element_ > 0;
+    }
+
+    double ns_per_element() const {
+        return ns_per_element_;
+    }
+
+    // Chunk size for n elements over `workers` workers: the whole range when all of it costs
+    // less than a chunk, otherwise at least 4 pieces per worker to balance
+    size_t grain(size_t n, size_t workers) const {
+        if (!tuned()) {
+            return std::max<size_t>(1, n / (workers * 8));
+        }
+        double ideal = static_cast<double>(target_chunk.count()) / ns_per_element_;
+        if (ideal >= static_cast<double>(n)) {
+            return std::max<size_t>(n, 1);
+        }
+        size_t balanced = std::max<size_t>(1, n / (workers * 4));
+        return std::clamp(static_cast<size_t>(ideal), size_t{1}, balanced);
+    }
+
+    // Folds in a measurement; the moving average follows loops whose cost drifts
+    void record(size_t elements, std::chrono::nanoseconds elapsed) {
+        if (elements == 0) {
+            return;
+        }
+        double sample = std::max(static_cast<double>(elapsed.count()), 1.0) /
+                        static_cast<double>(elements);
+        ns_per_element_ = tuned() ? 0.5 * ns_per_element_ + 0.5 * sample : sample;
+    }
+
+private:
+    double ns_per_element_ = 0;
+};
+
+class TaskScheduler {
+private:
+    struct Job;
+
+    // [begin, end) of one job, waiting in a deque
+    struct Task {
+        Job* job;
+        size_t begin;
+        size_t end;
+    };
+
+    struct Job {
+        void (*invoke)(void* body, size_t first, size_t last, Arena& scratch);
+        void* body;
+        size_t grain;
+        std::atomic<size_t> pending;  // Elements not yet run; the job is done at 0
+        std::atomic<int64_t> measured_ns{0};
+        std::atomic<size_t> measured_elements{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;  // Written once, by whoever set failed
+    };
+
+    struct alignas(64) Worker {
+        std::mutex mutex_;
+        std::deque<Task> tasks_;  // Owner: back. Thieves: front.
+        Arena scratch_;
+        std::atomic<size_t> chunks_{0};
+        std::atomic<size_t> steals_{0};
+        uint32_t rng_;
+
+        Worker(size_t scratch_bytes, uint32_t seed)
+            : scratch_(scratch_bytes, ArenaGrowthPolicy{}), rng_(seed) {}
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> active_jobs_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable_any wakeup_;
+    std::mutex caller_mutex_;  // One outside caller at a time owns worker 0
+    std::vector<std::jthread> threads_;  // Last, so they are stopped before the rest goes away
+
+    static inline thread_local TaskScheduler* current_scheduler_ = nullptr;
+    static inline thread_local Worker* current_worker_ = nullptr;
+
+public:
+    // threads counts the caller: TaskScheduler(1) runs everything on the calling thread
+    explicit TaskScheduler(size_t threads = std::max(1u, std::thread::hardware_concurrency()),
+                           size_t scratch_bytes = 64 * 1024) {
+        threads = std::max<size_t>(threads, 1);
+        for (size_t i = 0; i < threads; i++) {
+            auto seed = static_cast<uint32_t>(i * 2654435761u + 1);
+            workers_.push_back(std::make_unique<Worker>(scratch_bytes, seed));
+        }
+        for (size_t i = 1; i < threads; i++) {
+            threads_.emplace_back([this, i](std::stop_token stop) { worker_loop(i, stop); });
+        }
+        std::cout << "🧵 TaskScheduler started (" << threads << " workers)\n";
+    }
+
+    ~TaskScheduler() {
+        for (auto& thread : threads_) {
+            thread.request_stop();
+        }
+        threads_.clear();  // Joins
+        std::cout << "🧵 TaskScheduler stopped (" << chunks_run() << " chunks, " << steals()
+                  << " steals)\n";
+    }
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    size_t worker_count() const {
+        return workers_.size();
+    }
+
+    // Calls body(first, last) or body(first, last, scratch_arena) over disjoint chunks
+    // covering [begin, end), in parallel, and returns when all of them have run
+    template <typename Body>
+    void parallel_for(size_t begin, size_t end, Body&& body, size_t grain) {
+        run(begin, end, body, grain, nullptr);
+    }
+
+    template <typename Body>
+    void parallel_for(size_t begin, size_t end, Body&& body, GrainTuner& tuner) {
+        run(begin, end, body, 0, &tuner);
+    }
+
+    // A one-off tuner: probes the element cost on every call
+    template <typename Body>
+    void parallel_for(size_t begin, size_t end, Body&& body) {
+        GrainTuner tuner;
+        run(begin, end, body, 0, &tuner);
+    }
+
+    size_t chunks_run() const {
+        size_t total = 0;
+        for (const auto& worker : workers_) {
+            total += worker->chunks_.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    size_t steals() const {
+        size_t total = 0;
+        for (const auto& worker : workers_) {
+            total += worker->steals_.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    template <typename Body>
+    static void invoke(void* body, size_t first, size_t last, Arena& scratch) {
+        auto& f = *static_cast<std::remove_reference_t<Body>*>(body);
+        if constexpr (std::is_invocable_v<decltype(f), size_t, size_t, Arena&>) {
+            f(first, last, scratch);
+        } else {
+            f(first, last);
+        }
+    }
+
+    template <typename Body>
+    void run(size_t begin, size_t end, Body& body, size_t grain, GrainTuner* tuner) {
+        if (begin >= end) {
+            return;
+        }
+
+        // Outside callers borrow worker 0; calls from inside a body use their own worker
+        bool outside = current_scheduler_ != this;
+        std::unique_lock<std::mutex> caller;
+        if (outside) {
+            caller = std::unique_lock<std::mutex>(caller_mutex_);
+        }
+        TaskScheduler* saved_scheduler = current_scheduler_;
+        Worker* saved_worker = current_worker_;
+        Worker& self = outside ? *workers_[0] : *current_worker_;
+        current_scheduler_ = this;
+        current_worker_ = &self;
+
+        Job job{&invoke<Body>, const_cast<void*>(static_cast<const void*>(&body)), grain, {0}};
+        if (tuner && !tuner->tuned()) {
+            begin = probe(job, begin, end, self, *tuner);
+        }
+        if (tuner) {
+            job.grain = tuner->grain(end - begin, workers_.size());
+        }
+        job.grain = std::max<size_t>(job.grain, 1);
+        job.pending.store(end - begin, std::memory_order_relaxed);
+
+        if (begin < end) {
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex_);
+                active_jobs_.fetch_add(1, std::memory_order_relaxed);
+            }
+            wakeup_.notify_all();
+
+            execute({&job, begin, end}, self);
+            // Help with whatever is queued (this job's pieces or others') until ours is done
+            while (job.pending.load(std::memory_order_acquire) != 0) {
+                if (!run_one(self)) {
+                    std::this_thread::yield();
+                }
+            }
+            active_jobs_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        if (tuner) {
+            size_t elements = job.measured_elements.load(std::memory_order_relaxed);
+            tuner->record(elements, std::chrono::nanoseconds(
+                                        job.measured_ns.load(std::memory_order_relaxed)));
+        }
+        current_scheduler_ = saved_scheduler;
+        current_worker_ = saved_worker;
+        if (job.failed.load(std::memory_order_acquire)) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+    // Runs chunks of 1, 2, 4, ... elements from the front of the range on the calling thread
+    // until one takes a noticeable fraction of a target chunk, and seeds the tuner with it.
+    // Returns where the parallel part starts.
+    size_t probe(Job& job, size_t begin, size_t end, Worker& self, GrainTuner& tuner) {
+        using namespace std::chrono;
+        for (size_t size = 1; begin < end; size *= 2) {
+            size_t last = std::min(end, begin + size);
+            auto start = steady_clock::now();
+            run_chunk(job, begin, last, self);
+            auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start);
+            tuner.record(last - begin, elapsed);
+            begin = last;
+            if (elapsed >= GrainTuner::target_chunk / 4) {
+                break;
+            }
+        }
+        return begin;
+    }
+
+    // Splits down to the grain, pushing the upper halves for itself or thieves, then runs
+    // what is left
+    void execute(Task task, Worker& self) {
+        Job& job = *task.job;
+        while (task.end - task.begin > job.grain) {
+            size_t middle = task.begin + (task.end - task.begin) / 2;
+            {
+                std::lock_guard<std::mutex> lock(self.mutex_);
+                self.tasks_.push_back({&job, middle, task.end});
+            }
+            task.end = middle;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        run_chunk(job, task.begin, task.end, self);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        job.measured_ns.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+            std::memory_order_relaxed);
+        job.measured_elements.fetch_add(task.end - task.begin, std::memory_order_relaxed);
+        self.chunks_.fetch_add(1, std::memory_order_relaxed);
+        // Last touch of the job: once pending reaches 0 its owner may return
+        job.pending.fetch_sub(task.end - task.begin, std::memory_order_acq_rel);
+    }
+
+    void run_chunk(Job& job, size_t first, size_t last, Worker& self) {
+        if (job.failed.load(std::memory_order_relaxed)) {
+            return;  // Skip the rest of a loop that already threw
+        }
+        try {
+            ArenaScope<Arena> scope(self.scratch_);
+            job.invoke(job.body, first, last, self.scratch_);
+        } catch (...) {
+            if (!job.failed.exchange(true, std::memory_order_acq_rel)) {
+                job.error = std::current_exception();
+            }
+        }
+    }
+
+    // Own deque first (back), then one pass over the others (front). Returns whether a task
+    // was run.
+    bool run_one(Worker& self) {
+        Task task;
+        if (pop(self, task) || steal(self, task)) {
+            execute(task, self);
+            return true;
+        }
+        return false;
+    }
+
+    static bool pop(Worker& self, Task& task) {
+        std::lock_guard<std::mutex> lock(self.mutex_);
+        if (self.tasks_.empty()) {
+            return false;
+        }
+        task = self.tasks_.back();
+        self.tasks_.pop_back();
+        return true;
+    }
+
+    bool steal(Worker& self, Task& task) {
+        size_t count = workers_.size();
+        if (count == 1) {
+            return false;
+        }
+        // xorshift32: a random first victim, so thieves don't all hit worker 0
+        self.rng_ ^= self.rng_ << 13;
+        self.rng_ ^= self.rng_ >> 17;
+        self.rng_ ^= self.rng_ << 5;
+        size_t first = self.rng_ % count;
+        for (size_t i = 0; i < count; i++) {
+            Worker& victim = *workers_[(first + i) % count];
+            if (&victim == &self) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(victim.mutex_);
+            if (!victim.tasks_.empty()) {
+                task = victim.tasks_.front();
+                victim.tasks_.pop_front();
+                self.steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker_loop(size_t index, std::stop_token stop) {
+        Worker& self = *workers_[index];
+        current_scheduler_ = this;
+        current_worker_ = &self;
+
+        while (!stop.stop_requested()) {
+            if (run_one(self)) {
+                continue;
+            }
+            if (active_jobs_.load(std::memory_order_relaxed) == 0) {
+                // Nothing running: sleep until a parallel_for starts or the destructor stops us
+                std::unique_lock<std::mutex> lock(sleep_mutex_);
+                wakeup_.wait(lock, stop,
+                             [this] { return active_jobs_.load(std::memory_order_relaxed) > 0; });
+                continue;
+            }
+            std::this_thread::yield();  // A job is running but nothing is left to steal yet
+        }
+    }
+};
@@ -0,0 +1,37 @@
+/*
+ * AVX-512 particle kernel: 16 particles per instruction, one cache line per stream
+ * (see include/particle_kernels.hpp)
+ */
+
+#include "particle_kernels.hpp"
+
+#if IMPSTUDY_SIMD_KERNELS
+#include <immintrin.h>
+
+namespace {
+
+// p[i..i+16) += v[i..i+16) * dt for the lanes in mask; the streams are 64-byte aligned
+inline void advance(float* p, const float* v, size_t i, __m512 dt, __mmask16 mask) {
+    __m512 moved = _mm512_fmadd_ps(_mm512_maskz_load_ps(mask, v + i), dt,
+                                   _mm512_maskz_load_ps(mask, p + i));
+    _mm512_mask_store_ps(p + i, mask, moved);
+}
+
+}  // namespace
+
+void update_particles_avx512(const ParticleStreams& streams, float dt) {
+    // A local copy: vector stores may alias anything, so reading the pointers through the
+    // reference would reload all of them on every iteration
+    const ParticleStreams s = streams;
+    const __m512 step = _mm512_set1_ps(dt);
+    for (size_t i = 0; i < s.count; i += 16) {
+        size_t rest = s.count - i;
+        const __mmask16 mask = rest >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << rest) - 1);
+        advance(s.x, s.vx, i, step, mask);
+        advance(s.y, s.vy, i, step, mask);
+        advance(s.z, s.vz, i, step, mask);
+        __m512 life = _mm512_sub_ps(_mm512_maskz_load_ps(mask, s.life + i), step);
+        _mm512_mask_store_ps(s.life + i, mask, life);
+    }
+}
+#endif
@@ -0,0 +1,38 @@
+/*
+ * SSE2 particle kernel: 4 particles per instruction (see include/particle_kernels.hpp)
+ */
+
+#include "particle_kernels.hpp"
+
+#if IMPSTUDY_SIMD_KERNELS
+#include <immintrin.h>
+
+namespace {
+
+// p[i..i+4) += v[i..i+4) * dt; the streams are 64-byte aligned, so i % 4 == 0 is enough
+inline void advance(float* p, const float* v, size_t i, __m128 dt) {
+    _mm_store_ps(p + i, _mm_add_ps(_mm_load_ps(p + i), _mm_mul_ps(_mm_load_ps(v + i), dt)));
+}
+
+}  // namespace
+
+void update_particles_sse2(const ParticleStreams& streams, float dt) {
+    // A local copy: vector stores may alias anything, so reading the pointers through the
+    // reference would reload all of them on every iteration
+    const ParticleStreams s = streams;
+    const __m128 step = _mm_set1_ps(dt);
+    size_t i = 0;
+    for (; i + 4 <= s.count; i += 4) {
+        advance(s.x, s.vx, i, step);
+        advance(s.y, s.vy, i, step);
+        advance(s.z, s.vz, i, step);
+        _mm_store_ps(s.life + i, _mm_sub_ps(_mm_load_ps(s.life + i), step));
+    }
+    for (; i < s.count; i++) {
+        s.x[i] += s.vx[i] * dt;
+        s.y[i] += s.vy[i] * dt;
+        s.z[i] += s.vz[i] * dt;
+        s.life[i] -= dt;
+    }
+}
+#endif